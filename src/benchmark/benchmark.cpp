@@ -0,0 +1,35 @@
+#include "benchmark.h"
+
+Q_GLOBAL_STATIC(QVector<Benchmark>, gBenchmarks)
+
+BenchmarkReport::BenchmarkReport(QTextStream &stream)
+    : m_stream(stream)
+{
+}
+
+void BenchmarkReport::writeHeader()
+{
+    m_stream << "benchmark,variant,panes,metric,value\n";
+    m_stream.flush();
+}
+
+void BenchmarkReport::add(const QString &benchmark, const QString &variant, int panes,
+                          const QString &metric, double value)
+{
+    m_stream << benchmark << ','
+             << variant << ','
+             << panes << ','
+             << metric << ','
+             << QString::number(value, 'f', 3) << '\n';
+    m_stream.flush();
+}
+
+void registerBenchmark(const QString &name, const BenchmarkFunction &run)
+{
+    gBenchmarks->append({name, run});
+}
+
+QVector<Benchmark> benchmarks()
+{
+    return *gBenchmarks;
+}
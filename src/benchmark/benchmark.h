@@ -0,0 +1,48 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QString>
+#include <QVector>
+#include <QTextStream>
+
+#include <functional>
+
+struct BenchmarkOptions
+{
+    QVector<int> paneCounts;
+    int iterations = 5;
+};
+
+/**
+ * @brief The BenchmarkReport class
+ * Writes one CSV row per measured value, so results of different runs can be
+ * appended to the same file and compared over time.
+ */
+class BenchmarkReport
+{
+public:
+    explicit BenchmarkReport(QTextStream &stream);
+
+    void writeHeader();
+    void add(const QString &benchmark, const QString &variant, int panes,
+             const QString &metric, double value);
+
+private:
+    QTextStream &m_stream;
+};
+
+using BenchmarkFunction = std::function<void(const BenchmarkOptions &, BenchmarkReport &)>;
+
+struct Benchmark
+{
+    QString name;
+    BenchmarkFunction run;
+};
+
+void registerBenchmark(const QString &name, const BenchmarkFunction &run);
+QVector<Benchmark> benchmarks();
+
+void registerSplitterBenchmarks();
+void registerWindowFrameBenchmarks();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,54 @@
+QT       += core gui concurrent
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SPLITTERWINDOW = $$PWD/../splitterwindow
+WINDOWFRAME = $$PWD/../windowframe
+
+INCLUDEPATH += \
+    $$SPLITTERWINDOW \
+    $$WINDOWFRAME
+
+SOURCES += \
+    $$SPLITTERWINDOW/PaneIndex.cpp \
+    $$SPLITTERWINDOW/PaneOverview.cpp \
+    $$SPLITTERWINDOW/PaneRegistry.cpp \
+    $$SPLITTERWINDOW/SnapshotCover.cpp \
+    $$SPLITTERWINDOW/SplitArea.cpp \
+    $$SPLITTERWINDOW/SplitController.cpp \
+    $$SPLITTERWINDOW/SplitTransaction.cpp \
+    $$SPLITTERWINDOW/Splittable.cpp \
+    $$SPLITTERWINDOW/Splitter.cpp \
+    $$SPLITTERWINDOW/TitleBar.cpp \
+    $$SPLITTERWINDOW/Viewport.cpp \
+    $$SPLITTERWINDOW/ViewportContent.cpp \
+    $$SPLITTERWINDOW/Workspace.cpp \
+    $$WINDOWFRAME/windowframehelper.cpp \
+    benchmark.cpp \
+    splitterbench.cpp \
+    windowframebench.cpp \
+    main.cpp
+
+HEADERS += \
+    $$SPLITTERWINDOW/PaneIndex.h \
+    $$SPLITTERWINDOW/PaneOverview.h \
+    $$SPLITTERWINDOW/PaneRegistry.h \
+    $$SPLITTERWINDOW/SnapshotCover.h \
+    $$SPLITTERWINDOW/SplitArea.h \
+    $$SPLITTERWINDOW/SplitController.h \
+    $$SPLITTERWINDOW/SplitTransaction.h \
+    $$SPLITTERWINDOW/Splittable.h \
+    $$SPLITTERWINDOW/Splitter.h \
+    $$SPLITTERWINDOW/TitleBar.h \
+    $$SPLITTERWINDOW/Viewport.h \
+    $$SPLITTERWINDOW/ViewportContent.h \
+    $$SPLITTERWINDOW/Workspace.h \
+    $$WINDOWFRAME/windowframehelper.h \
+    benchmark.h
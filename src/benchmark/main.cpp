@@ -0,0 +1,77 @@
+#include "benchmark.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    // benchmarks never need a real screen
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("splitterwindow and windowframe benchmarks, CSV output");
+    parser.addHelpOption();
+    parser.addPositionalArgument("benchmarks", "Benchmarks to run, all if empty.", "[name...]");
+    QCommandLineOption panesOption("panes", "Comma separated pane counts.", "counts", "1,10,50,100,250,500");
+    QCommandLineOption iterationsOption("iterations", "Iterations per measurement.", "count", "5");
+    QCommandLineOption outputOption("output", "Append CSV rows to file instead of stdout.", "file");
+    QCommandLineOption listOption("list", "List available benchmarks.");
+    parser.addOption(panesOption);
+    parser.addOption(iterationsOption);
+    parser.addOption(outputOption);
+    parser.addOption(listOption);
+    parser.process(a);
+
+    registerSplitterBenchmarks();
+    registerWindowFrameBenchmarks();
+
+    if(parser.isSet(listOption))
+    {
+        QTextStream out(stdout);
+        for(const Benchmark &benchmark : benchmarks())
+            out << benchmark.name << '\n';
+        return 0;
+    }
+
+    BenchmarkOptions options;
+    for(const QString &count : parser.value(panesOption).split(',', Qt::SkipEmptyParts))
+        options.paneCounts << qMax(1, count.toInt());
+    options.iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    QFile file;
+    bool header = true;
+    if(parser.isSet(outputOption))
+    {
+        file.setFileName(parser.value(outputOption));
+        header = !file.exists() || file.size() == 0;
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        {
+            qWarning("Could not open %s", qPrintable(file.fileName()));
+            return 1;
+        }
+    }
+    else
+    {
+        file.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+
+    QTextStream stream(&file);
+    BenchmarkReport report(stream);
+    if(header)
+        report.writeHeader();
+
+    const QStringList names = parser.positionalArguments();
+    for(const Benchmark &benchmark : benchmarks())
+    {
+        if(!names.isEmpty() && !names.contains(benchmark.name))
+            continue;
+        benchmark.run(options, report);
+    }
+
+    return 0;
+}
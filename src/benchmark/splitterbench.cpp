@@ -0,0 +1,659 @@
+#include "benchmark.h"
+#include "PaneOverview.h"
+#include "PaneRegistry.h"
+#include "SplitArea.h"
+#include "SplitController.h"
+#include "Splittable.h"
+#include "Splitter.h"
+#include "SplitTransaction.h"
+#include "Viewport.h"
+#include "Workspace.h"
+
+#include <QApplication>
+#include <QMouseEvent>
+#include <QStackedWidget>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QtMath>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+enum TreeShape
+{
+    BalancedTree,   // every pane split in turn, depth grows with log(n)
+    DegenerateTree  // the newest pane split each time, depth grows with n
+};
+
+static const char *shapeName(TreeShape shape)
+{
+    return shape == BalancedTree ? "balanced" : "degenerate";
+}
+
+static qint64 heapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return qint64(mallinfo2().uordblks);
+#elif defined(__GLIBC__)
+    return qint64(mallinfo().uordblks);
+#else
+    return -1;
+#endif
+}
+
+static void flushEvents()
+{
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QApplication::processEvents();
+}
+
+/**
+ * @brief buildTree
+ * Grow a tree to \a panes panes. Directions alternate with the depth, so
+ * the degenerate shape nests a new level for every split.
+ * @return the time spent in Splittable::split(), in nanoseconds
+ */
+static qint64 buildTree(Splittable *root, int panes, TreeShape shape)
+{
+    QElapsedTimer timer;
+    qint64 elapsed = 0;
+
+    QQueue<QPair<Splittable *, int>> queue;
+    queue.enqueue(qMakePair(root, 0));
+    for(int count = 1; count < panes && !queue.isEmpty(); ++count)
+    {
+        const QPair<Splittable *, int> pane = shape == BalancedTree ? queue.dequeue() : queue.takeLast();
+        const Qt::Orientation orientation = pane.second % 2 ? Qt::Vertical : Qt::Horizontal;
+
+        timer.start();
+        Splittable *next = pane.first->split(orientation, 1);
+        elapsed += timer.nsecsElapsed();
+
+        if(!next)
+            break;
+        if(shape == BalancedTree)
+            queue.enqueue(qMakePair(pane.first->hasSplitter() ? static_cast<Splittable *>(
+                                        pane.first->splitter()->widget(0)) : pane.first, pane.second + 1));
+        queue.enqueue(qMakePair(next, pane.second + 1));
+    }
+    return elapsed;
+}
+
+/**
+ * @brief buildArea
+ * The same shapes on a SplitArea, with a Viewport per pane.
+ */
+static void buildArea(SplitArea *area, int panes, TreeShape shape)
+{
+    QQueue<QPair<int, int>> queue;
+    queue.enqueue(qMakePair(area->addPane(new Viewport(nullptr)), 0));
+    for(int count = 1; count < panes && !queue.isEmpty(); ++count)
+    {
+        const QPair<int, int> pane = shape == BalancedTree ? queue.dequeue() : queue.takeLast();
+        const Qt::Orientation orientation = pane.second % 2 ? Qt::Vertical : Qt::Horizontal;
+        const int next = area->split(pane.first, orientation, new Viewport(nullptr), 1);
+        if(shape == BalancedTree)
+            queue.enqueue(qMakePair(pane.first, pane.second + 1));
+        queue.enqueue(qMakePair(next, pane.second + 1));
+    }
+}
+
+static void collectPanes(Splittable *pane, QList<Splittable *> &panes)
+{
+    QSplitter *splitter = pane->splitter();
+    if(!splitter)
+    {
+        panes << pane;
+        return;
+    }
+
+    for(int i = 0; i < splitter->count(); ++i)
+    {
+        if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+            collectPanes(child, panes);
+    }
+}
+
+static int treeDepth(Splittable *pane)
+{
+    int depth = 0;
+    QSplitter *splitter = pane->splitter();
+    for(int i = 0; splitter && i < splitter->count(); ++i)
+    {
+        if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+            depth = qMax(depth, 1 + treeDepth(child));
+    }
+    return depth;
+}
+
+// the per-pane style sheet Viewport used before the shared palette
+static const char *LegacyStyleSheet = "background-color: #333333; color: #999999; font-size: 20px";
+
+/**
+ * @brief benchmarkPolish
+ * Creates and polishes N viewports, once with the legacy per-pane style sheet
+ * and once with the shared palette.
+ */
+static void benchmarkPolish(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(int panes : options.paneCounts)
+    {
+        for(bool styleSheet : {true, false})
+        {
+            qint64 elapsed = 0;
+            for(int i = 0; i < options.iterations; ++i)
+            {
+                QWidget window;
+                auto layout = new QVBoxLayout(&window);
+
+                QElapsedTimer timer;
+                timer.start();
+                for(int pane = 0; pane < panes; ++pane)
+                {
+                    auto viewport = new Viewport(nullptr, &window);
+                    if(styleSheet)
+                        viewport->findChild<QStackedWidget *>()->setStyleSheet(LegacyStyleSheet);
+                    layout->addWidget(viewport);
+                }
+                window.ensurePolished();
+                elapsed += timer.nsecsElapsed();
+            }
+
+            report.add("polish", styleSheet ? "stylesheet" : "palette", panes,
+                       "ms", elapsed / 1e6 / options.iterations);
+        }
+    }
+}
+
+/**
+ * @brief benchmarkHover
+ * Cost of one mouse move over the window, in the client area of a pane, on a
+ * corner zone and while moving between the two, which changes the cursor on
+ * every event. Should not depend on the number of panes.
+ */
+static void benchmarkHover(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(int panes : options.paneCounts)
+    {
+        Splittable root;
+        root.resize(1280, 960);
+        buildTree(&root, panes, BalancedTree);
+        root.show();
+        QApplication::processEvents();
+
+        QRect rect;
+        root.controller()->paneAt(QPoint(0, 0), &rect);
+        const QPoint client = rect.center();
+        const QPoint corner = rect.topLeft() + QPoint(2, 2);
+        const struct { const char *name; QPoint from; QPoint to; } variants[] = {
+            { "client", client, client + QPoint(1, 1) },
+            { "corner", corner, corner + QPoint(1, 1) },
+            { "transition", client, corner },
+        };
+
+        const int events = 20000 * options.iterations;
+        for(const auto &variant : variants)
+        {
+            QWidget *from = root.childAt(variant.from);
+            QWidget *to = root.childAt(variant.to);
+
+            QElapsedTimer timer;
+            timer.start();
+            for(int i = 0; i < events; ++i)
+            {
+                const QPoint pos = i % 2 ? variant.to : variant.from;
+                QWidget *receiver = i % 2 ? to : from;
+                QMouseEvent event(QEvent::MouseMove, receiver->mapFrom(&root, pos), root.mapToGlobal(pos),
+                                  Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+                QApplication::sendEvent(receiver, &event);
+            }
+            report.add("hover", variant.name, panes, "ns_per_event", double(timer.nsecsElapsed()) / events);
+        }
+    }
+}
+
+/**
+ * @brief benchmarkSplit
+ * Latency of Splittable::split() while building a tree and of
+ * Splittable::unsplit() while taking it down again, pending deletes
+ * included.
+ */
+static void benchmarkSplit(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(TreeShape shape : {BalancedTree, DegenerateTree})
+    {
+        for(int panes : options.paneCounts)
+        {
+            if(panes < 2)
+                continue;
+
+            qint64 splitting = 0;
+            qint64 unsplitting = 0;
+            int unsplits = 0;
+            for(int i = 0; i < options.iterations; ++i)
+            {
+                Splittable root;
+                root.resize(1280, 960);
+                root.show();
+                splitting += buildTree(&root, panes, shape);
+                flushEvents();
+
+                QElapsedTimer timer;
+                for(;;)
+                {
+                    QList<Splittable *> leaves;
+                    collectPanes(&root, leaves);
+                    if(leaves.count() < 2)
+                        break;
+
+                    timer.start();
+                    leaves.last()->unsplit();
+                    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+                    unsplitting += timer.nsecsElapsed();
+                    ++unsplits;
+                }
+            }
+
+            report.add("split", shapeName(shape), panes, "us_per_split",
+                       splitting / 1e3 / (options.iterations * (panes - 1)));
+            report.add("unsplit", shapeName(shape), panes, "us_per_unsplit",
+                       unsplits ? unsplitting / 1e3 / unsplits : 0);
+        }
+    }
+}
+
+/**
+ * @brief benchmarkResize
+ * Full window resize, layout and paint included, for Splittable trees and
+ * the same shapes on a SplitArea.
+ */
+static void benchmarkResize(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    const QSize sizes[] = { QSize(1280, 960), QSize(1600, 1200), QSize(1024, 768) };
+    const int resizes = 20 * options.iterations;
+
+    for(TreeShape shape : {BalancedTree, DegenerateTree})
+    {
+        for(int panes : options.paneCounts)
+        {
+            Splittable root;
+            root.resize(sizes[0]);
+            buildTree(&root, panes, shape);
+            root.show();
+            flushEvents();
+
+            SplitArea area;
+            area.resize(sizes[0]);
+            buildArea(&area, panes, shape);
+            area.show();
+            flushEvents();
+
+            const struct { const char *name; QWidget *widget; } variants[] = {
+                { "splittable", &root },
+                { "splitarea", &area },
+            };
+
+            for(const auto &variant : variants)
+            {
+                QElapsedTimer timer;
+                timer.start();
+                for(int i = 0; i < resizes; ++i)
+                {
+                    variant.widget->resize(sizes[i % 3]);
+                    QApplication::processEvents();
+                }
+                report.add("resize", QString("%1/%2").arg(shapeName(shape), variant.name), panes,
+                           "ms_per_resize", timer.nsecsElapsed() / 1e6 / resizes);
+            }
+
+            report.add("depth", shapeName(shape), panes, "levels", treeDepth(&root));
+        }
+    }
+}
+
+/**
+ * @brief benchmarkDrag
+ * Frame time of dragging the top level handle with opaque resize, one mouse
+ * move and the following layout and paint per frame.
+ */
+static void benchmarkDrag(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(TreeShape shape : {BalancedTree, DegenerateTree})
+    {
+        for(int panes : options.paneCounts)
+        {
+            if(panes < 2)
+                continue;
+
+            Splittable root;
+            root.resize(1280, 960);
+            buildTree(&root, panes, shape);
+            root.show();
+            flushEvents();
+
+            auto splitter = qobject_cast<Splitter *>(root.splitter());
+            if(!splitter)
+                continue;
+            splitter->setResizeMode(Splitter::OpaqueResize);
+
+            QSplitterHandle *handle = splitter->handle(1);
+            const QPoint center = handle->rect().center();
+            auto send = [handle](QEvent::Type type, const QPoint &pos, Qt::MouseButton button, Qt::MouseButtons buttons) {
+                QMouseEvent event(type, pos, handle->mapToGlobal(pos), button, buttons, Qt::NoModifier);
+                QApplication::sendEvent(handle, &event);
+            };
+
+            const int frames = 50 * options.iterations;
+            send(QEvent::MouseButtonPress, center, Qt::LeftButton, Qt::LeftButton);
+            QElapsedTimer timer;
+            timer.start();
+            for(int i = 0; i < frames; ++i)
+            {
+                const int offset = (i % 20 < 10 ? i % 10 : 10 - i % 10) * 8 - 40;
+                const QPoint pos = splitter->orientation() == Qt::Horizontal
+                        ? center + QPoint(offset, 0) : center + QPoint(0, offset);
+                send(QEvent::MouseMove, pos, Qt::NoButton, Qt::LeftButton);
+                QApplication::processEvents();
+            }
+            const qint64 elapsed = timer.nsecsElapsed();
+            send(QEvent::MouseButtonRelease, center, Qt::LeftButton, Qt::NoButton);
+
+            report.add("drag", shapeName(shape), panes, "ms_per_frame", elapsed / 1e6 / frames);
+        }
+    }
+}
+
+/**
+ * @brief splitGrid
+ * Split \a root into a grid of \a columns by \a rows panes, one split at a
+ * time or queued on \a transaction and committed at once.
+ */
+static void splitGrid(Splittable *root, int columns, int rows, SplitTransaction *transaction)
+{
+    PaneRegistry *registry = root->registry();
+    auto split = [&](int id, Qt::Orientation orientation) {
+        return transaction ? transaction->split(id, orientation)
+                           : registry->pane(id)->split(orientation)->paneId();
+    };
+
+    QVector<int> cells(1, root->paneId());
+    for(int column = 1; column < columns; ++column)
+        cells.append(split(cells.last(), Qt::Horizontal));
+    for(int column = 0; column < columns; ++column)
+    {
+        int cell = cells[column];
+        for(int row = 1; row < rows; ++row)
+            cell = split(cell, Qt::Vertical);
+    }
+
+    if(transaction)
+        transaction->commit();
+}
+
+/**
+ * @brief benchmarkTransaction
+ * Scripted grid layouts on a shown window, applied one split at a time or
+ * as one transaction, layout and paint included.
+ */
+static void benchmarkTransaction(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(int panes : options.paneCounts)
+    {
+        if(panes < 2)
+            continue;
+
+        const int columns = qCeil(qSqrt(panes));
+        const int rows = (panes + columns - 1) / columns;
+        for(bool batched : {false, true})
+        {
+            qint64 elapsed = 0;
+            for(int i = 0; i < options.iterations; ++i)
+            {
+                Splittable root;
+                root.resize(1280, 960);
+                root.show();
+                flushEvents();
+
+                QElapsedTimer timer;
+                timer.start();
+                SplitTransaction transaction = root.transaction();
+                splitGrid(&root, columns, rows, batched ? &transaction : nullptr);
+                QApplication::processEvents();
+                elapsed += timer.nsecsElapsed();
+            }
+
+            report.add("transaction", batched ? "batched" : "direct", columns * rows, "ms_per_grid",
+                       elapsed / 1e6 / options.iterations);
+        }
+    }
+}
+
+/**
+ * @brief benchmarkOverview
+ * Opening the thumbnail overview of a shown tree: the longest single pass
+ * of the event loop, which is how long the GUI thread is blocked, and the
+ * time until every thumbnail is ready. Opened a second time without
+ * repaints nothing is grabbed again.
+ */
+static void benchmarkOverview(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(int panes : options.paneCounts)
+    {
+        QWidget window;
+        window.resize(1280, 960);
+        auto root = new Splittable;
+        root->setParent(&window);
+        root->resize(window.size());
+        buildTree(root, panes, BalancedTree);
+        window.show();
+        flushEvents();
+
+        PaneOverview overview(root, &window);
+        for(const char *variant : {"cold", "warm"})
+        {
+            qint64 longest = 0;
+            QElapsedTimer total;
+            total.start();
+            overview.open();
+            while(overview.pendingThumbnails() > 0)
+            {
+                QElapsedTimer slice;
+                slice.start();
+                QApplication::processEvents();
+                longest = qMax(longest, slice.nsecsElapsed());
+            }
+            const qint64 elapsed = total.nsecsElapsed();
+            overview.hide();
+            flushEvents();
+
+            report.add("overview", variant, panes, "max_slice_ms", longest / 1e6);
+            report.add("overview", variant, panes, "ms_to_complete", elapsed / 1e6);
+        }
+    }
+}
+
+/**
+ * @brief benchmarkPreset
+ * Switching between two workspace presets of the same shape, both kept
+ * alive or the hidden one dropped by a tiny budget and restored from its
+ * saved layout.
+ */
+static void benchmarkPreset(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    const int switches = 10 * options.iterations;
+    for(int panes : options.paneCounts)
+    {
+        for(bool alive : {true, false})
+        {
+            Workspace workspace;
+            workspace.resize(1280, 960);
+            buildTree(workspace.addPreset("first"), panes, BalancedTree);
+            buildTree(workspace.addPreset("second"), panes, BalancedTree);
+            workspace.setMemoryBudget(alive ? 0 : 1);
+            workspace.show();
+            flushEvents();
+
+            QElapsedTimer timer;
+            timer.start();
+            for(int i = 0; i < switches; ++i)
+            {
+                workspace.setCurrentPreset(i % 2 ? "first" : "second");
+                flushEvents();
+            }
+
+            report.add("preset", alive ? "alive" : "restored", panes, "ms_per_switch",
+                       timer.nsecsElapsed() / 1e6 / switches);
+        }
+    }
+}
+
+/**
+ * @brief benchmarkDrift
+ * Resize a tree a thousand times through random sizes and back to where it
+ * started, then compare every pane with its first geometry.
+ */
+static void benchmarkDrift(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    const int resizes = 1000;
+    for(TreeShape shape : {BalancedTree, DegenerateTree})
+    {
+        for(int panes : options.paneCounts)
+        {
+            Splittable root;
+            root.resize(1280, 960);
+            buildTree(&root, panes, shape);
+            root.show();
+            flushEvents();
+
+            QList<Splittable *> leaves;
+            collectPanes(&root, leaves);
+            QVector<QRect> before;
+            for(Splittable *pane : qAsConst(leaves))
+                before.append(QRect(pane->mapTo(&root, QPoint(0, 0)), pane->size()));
+
+            QElapsedTimer timer;
+            timer.start();
+            quint32 seed = 1;
+            for(int i = 0; i < resizes; ++i)
+            {
+                // a fixed sequence, every run resizes the same way
+                seed = seed * 1664525u + 1013904223u;
+                root.resize(640 + int(seed >> 8) % 1280, 480 + int(seed >> 20) % 960);
+            }
+            root.resize(1280, 960);
+            const qint64 elapsed = timer.nsecsElapsed();
+            flushEvents();
+
+            int drift = 0;
+            for(int i = 0; i < leaves.count(); ++i)
+            {
+                const QRect after(leaves[i]->mapTo(&root, QPoint(0, 0)), leaves[i]->size());
+                drift = qMax(drift, qAbs(after.left() - before[i].left()) + qAbs(after.right() - before[i].right()));
+                drift = qMax(drift, qAbs(after.top() - before[i].top()) + qAbs(after.bottom() - before[i].bottom()));
+            }
+
+            report.add("drift", shapeName(shape), panes, "max_drift_px", drift);
+            report.add("drift", shapeName(shape), panes, "us_per_resize", elapsed / 1e3 / resizes);
+        }
+    }
+}
+
+/**
+ * @brief benchmarkSuspend
+ * Collapse every other leaf before the tree is first shown, then count the
+ * panes that report being suspended and those whose viewport disagrees
+ * with its pane, which should be none.
+ */
+static void benchmarkSuspend(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(int panes : options.paneCounts)
+    {
+        Splittable root;
+        root.resize(1280, 960);
+        buildTree(&root, panes, BalancedTree);
+
+        QList<Splittable *> leaves;
+        collectPanes(&root, leaves);
+        for(int i = 0; i < leaves.count(); i += 2)
+        {
+            QSplitter *splitter = qobject_cast<QSplitter *>(leaves[i]->parentWidget());
+            if(!splitter)
+                continue;
+            QList<int> sizes = splitter->sizes();
+            const int index = splitter->indexOf(leaves[i]);
+            const int neighbour = index + 1 < sizes.count() ? index + 1 : index - 1;
+            sizes[neighbour] += sizes[index];
+            sizes[index] = 0;
+            splitter->setSizes(sizes);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        root.show();
+        flushEvents();
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        int suspended = 0;
+        int mismatched = 0;
+        for(Splittable *pane : qAsConst(leaves))
+        {
+            auto viewport = qobject_cast<Viewport *>(pane->widget());
+            suspended += pane->isSuspended() ? 1 : 0;
+            mismatched += viewport && viewport->isSuspended() != pane->isSuspended() ? 1 : 0;
+        }
+
+        report.add("suspend", "collapsed", panes, "suspended_panes", suspended);
+        report.add("suspend", "collapsed", panes, "mismatched_panes", mismatched);
+        report.add("suspend", "collapsed", panes, "ms_to_show", elapsed / 1e6);
+    }
+}
+
+/**
+ * @brief benchmarkMemory
+ * Widgets, QObjects and heap bytes per pane of a shown tree.
+ */
+static void benchmarkMemory(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    for(TreeShape shape : {BalancedTree, DegenerateTree})
+    {
+        for(int panes : options.paneCounts)
+        {
+            flushEvents();
+            const qint64 before = heapBytes();
+
+            auto root = new Splittable;
+            root->resize(1280, 960);
+            buildTree(root, panes, shape);
+            root->show();
+            flushEvents();
+
+            const qint64 after = heapBytes();
+            const int widgets = root->findChildren<QWidget *>().count() + 1;
+            const int objects = root->findChildren<QObject *>().count() + 1;
+
+            report.add("memory", shapeName(shape), panes, "widgets_per_pane", double(widgets) / panes);
+            report.add("memory", shapeName(shape), panes, "qobjects_per_pane", double(objects) / panes);
+            if(before >= 0)
+                report.add("memory", shapeName(shape), panes, "heap_bytes_per_pane", double(after - before) / panes);
+
+            delete root;
+        }
+    }
+}
+
+void registerSplitterBenchmarks()
+{
+    registerBenchmark("polish", benchmarkPolish);
+    registerBenchmark("hover", benchmarkHover);
+    registerBenchmark("split", benchmarkSplit);
+    registerBenchmark("resize", benchmarkResize);
+    registerBenchmark("drag", benchmarkDrag);
+    registerBenchmark("transaction", benchmarkTransaction);
+    registerBenchmark("overview", benchmarkOverview);
+    registerBenchmark("preset", benchmarkPreset);
+    registerBenchmark("drift", benchmarkDrift);
+    registerBenchmark("suspend", benchmarkSuspend);
+    registerBenchmark("memory", benchmarkMemory);
+}
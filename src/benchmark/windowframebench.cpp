@@ -0,0 +1,109 @@
+#include "benchmark.h"
+#include "windowframehelper.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGridLayout>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QWidget>
+
+/**
+ * @brief createWindow
+ * A top level window with a grid of labels, so event delivery to the window
+ * itself costs what it costs in a real application.
+ */
+static QWidget *createWindow(bool frameless)
+{
+    QWidget *window = new QWidget;
+    QGridLayout *layout = new QGridLayout(window);
+    for(int i = 0; i < 64; ++i)
+        layout->addWidget(new QLabel(QString::number(i), window), i / 8, i % 8);
+
+    window->setAttribute(Qt::WA_Hover);
+    window->setMouseTracking(true);
+    window->resize(1280, 960);
+    if(frameless)
+        WindowFrameHelper::makeWindowFrameless(window);
+    window->show();
+    QApplication::processEvents();
+    return window;
+}
+
+enum EventKind
+{
+    ClientEvents,   // hover and mouse moves inside the client area
+    BorderEvents,   // hover and mouse moves along the left border band
+    CrossingEvents, // hover and mouse moves in and out of the border band
+    OtherEvents     // events the frame does not care about
+};
+
+static qint64 deliver(QWidget *window, EventKind kind, int events)
+{
+    const QPoint client = window->rect().center();
+    const QPoint border(2, window->height() / 2);
+    const QPoint pos = kind == BorderEvents ? border : client;
+
+    QElapsedTimer timer;
+    timer.start();
+    for(int i = 0; i < events; ++i)
+    {
+        const QPoint p = kind == CrossingEvents ? (i % 4 < 2 ? border : client)
+                                                : pos + QPoint(0, i % 2);
+        if(kind == OtherEvents)
+        {
+            QEvent event(QEvent::User);
+            QApplication::sendEvent(window, &event);
+        }
+        else if(i % 2)
+        {
+            QHoverEvent event(QEvent::HoverMove, p, p - QPoint(0, 1));
+            QApplication::sendEvent(window, &event);
+        }
+        else
+        {
+            QMouseEvent event(QEvent::MouseMove, p, window->mapToGlobal(p),
+                              Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+            QApplication::sendEvent(window, &event);
+        }
+    }
+    return timer.nsecsElapsed();
+}
+
+/**
+ * @brief benchmarkFrame
+ * Per event overhead the frameless helper adds to a busy top level window:
+ * the same events are sent to a plain window and to a frameless one. Moves
+ * over the client area or along one edge and unrelated events should cost
+ * next to nothing, only crossing the border band changes the cursor.
+ */
+static void benchmarkFrame(const BenchmarkOptions &options, BenchmarkReport &report)
+{
+    QWidget *plain = createWindow(false);
+    QWidget *frameless = createWindow(true);
+
+    const struct { const char *name; EventKind kind; } variants[] = {
+        { "client", ClientEvents },
+        { "border", BorderEvents },
+        { "crossing", CrossingEvents },
+        { "other", OtherEvents },
+    };
+
+    const int events = 20000 * options.iterations;
+    for(const auto &variant : variants)
+    {
+        const double base = double(deliver(plain, variant.kind, events)) / events;
+        const double framed = double(deliver(frameless, variant.kind, events)) / events;
+        report.add("frame", variant.name, 1, "plain_ns_per_event", base);
+        report.add("frame", variant.name, 1, "frameless_ns_per_event", framed);
+        report.add("frame", variant.name, 1, "overhead_ns_per_event", framed - base);
+    }
+
+    delete frameless;
+    delete plain;
+}
+
+void registerWindowFrameBenchmarks()
+{
+    registerBenchmark("frame", benchmarkFrame);
+}
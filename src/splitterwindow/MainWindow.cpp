@@ -1,5 +1,7 @@
 #include "MainWindow.h"
+#include "PaneOverview.h"
 #include "Splittable.h"
+#include "Workspace.h"
 
 #include <QtWidgets>
 
@@ -9,12 +11,44 @@ MainWindow::MainWindow(QWidget *parent)
     resize(480, 320);
 //    setWindowFlags(windowFlags() | Qt::WindowStaysOnTopHint);
 
-    Splittable *splittable = new Splittable();
-    splittable->setParent(this);
-    this->setCentralWidget(splittable);
+    m_workspace = new Workspace(this);
+    this->setCentralWidget(m_workspace);
+
+    // Ctrl+1, Ctrl+2, ... switch presets, hidden ones stay alive
+    const QStringList presets = { "debug", "review", "monitor" };
+    for(int i = 0; i < presets.count(); ++i)
+    {
+        const QString name = presets[i];
+        m_workspace->addPreset(name);
+        auto shortcut = new QShortcut(QKeySequence(Qt::CTRL | (Qt::Key_1 + i)), this);
+        connect(shortcut, &QShortcut::activated, m_workspace, [this, name] {
+            m_workspace->setCurrentPreset(name);
+        });
+    }
+
+    auto overview = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_O), this);
+    connect(overview, &QShortcut::activated, this, &MainWindow::toggleOverview);
+    connect(m_workspace, &Workspace::currentPresetChanged, this, [this] {
+        for(const QPointer<PaneOverview> &overview : qAsConst(m_overviews))
+        {
+            if(overview)
+                overview->hide();
+        }
+    });
 }
 
 MainWindow::~MainWindow()
 {
 }
 
+void MainWindow::toggleOverview()
+{
+    // one overview per preset, so its thumbnails survive switching presets
+    Splittable *root = m_workspace->currentRoot();
+    QPointer<PaneOverview> &overview = m_overviews[m_workspace->currentPreset()];
+    if(overview && overview->root() != root)
+        delete overview; // the preset was dropped and restored as a new tree
+    if(!overview)
+        overview = new PaneOverview(root, m_workspace);
+    overview->toggle();
+}
@@ -2,8 +2,12 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QHash>
+#include <QPointer>
 
 class SplitterWidget;
+class PaneOverview;
+class Workspace;
 
 class MainWindow : public QMainWindow
 {
@@ -14,6 +18,10 @@ public:
     ~MainWindow();
 
 private:
+    void toggleOverview();
+
     SplitterWidget *m_splitter = nullptr;
+    Workspace *m_workspace = nullptr;
+    QHash<QString, QPointer<PaneOverview>> m_overviews;
 };
 #endif // MAINWINDOW_H
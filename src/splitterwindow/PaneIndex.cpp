@@ -0,0 +1,292 @@
+#include "PaneIndex.h"
+#include "Splittable.h"
+
+#include <QSet>
+#include <QSplitter>
+
+PaneIndex::PaneIndex()
+{
+}
+
+/**
+ * @brief PaneIndex::rebuild
+ * Collect the visible leaf panes below \a root with their rectangles, the
+ * offsets are accumulated on the way down instead of mapping every pane to
+ * the root.
+ */
+void PaneIndex::rebuild(Splittable *root)
+{
+    clear();
+    if(!root)
+        return;
+
+    m_bounds = root->rect();
+    m_columns = qMax(1, (m_bounds.width() + CellSize - 1) / CellSize);
+    m_rows = qMax(1, (m_bounds.height() + CellSize - 1) / CellSize);
+    m_cells.resize(m_columns * m_rows);
+
+    collect(root, QPoint(0, 0));
+    m_valid = true;
+}
+
+void PaneIndex::clear()
+{
+    m_entries.clear();
+    m_free.clear();
+    m_lookup.clear();
+    m_cells.clear();
+    m_pending.clear();
+    m_bounds = QRect();
+    m_columns = 0;
+    m_rows = 0;
+    m_valid = false;
+}
+
+void PaneIndex::invalidate()
+{
+    m_valid = false;
+    m_pending.clear();
+}
+
+bool PaneIndex::isValid() const
+{
+    return m_valid;
+}
+
+/**
+ * @brief PaneIndex::update
+ * Queue \a pane, its geometry or visibility changed. Past MaximumPending
+ * queued panes a full rebuild is cheaper and the index is invalidated.
+ */
+void PaneIndex::update(Splittable *pane)
+{
+    if(!m_valid || !pane || m_pending.contains(pane))
+        return;
+
+    if(m_pending.count() >= MaximumPending)
+        return invalidate();
+    m_pending.append(pane);
+}
+
+/**
+ * @brief PaneIndex::refresh
+ * Bring the index up to date for \a root: rebuild it if it is invalid or
+ * the root was resized, else collect the subtrees of the queued panes.
+ */
+void PaneIndex::refresh(Splittable *root)
+{
+    if(!root)
+        return clear();
+    if(!m_valid || root->rect() != m_bounds)
+        return rebuild(root);
+    if(m_pending.isEmpty())
+        return;
+
+    QSet<const QWidget *> pending;
+    for(const QPointer<Splittable> &pane : qAsConst(m_pending))
+    {
+        if(pane)
+            pending.insert(pane);
+    }
+
+    const QVector<QPointer<Splittable>> panes = m_pending;
+    m_pending.clear();
+    for(const QPointer<Splittable> &pane : panes)
+    {
+        if(!pane || (pane != root && !root->isAncestorOf(pane)))
+            continue;
+
+        // the subtree of a queued ancestor covers this pane already
+        QPoint origin;
+        bool covered = false;
+        for(QWidget *widget = pane; widget != root; widget = widget->parentWidget())
+        {
+            origin += widget->pos();
+            if(widget != pane && pending.contains(widget))
+            {
+                covered = true;
+                break;
+            }
+        }
+        if(covered)
+            continue;
+
+        removeSubtree(pane);
+        collect(pane, origin);
+    }
+}
+
+Splittable *PaneIndex::paneAt(const QPoint &pos, QRect *rect) const
+{
+    const int cell = cellAt(pos);
+    if(cell < 0)
+        return nullptr;
+
+    for(int i : m_cells[cell])
+    {
+        const Entry &entry = m_entries[i];
+        if(entry.pane && entry.rect.contains(pos))
+        {
+            if(rect)
+                *rect = entry.rect;
+            return entry.pane;
+        }
+    }
+
+    return nullptr;
+}
+
+QRect PaneIndex::paneRect(const Splittable *pane) const
+{
+    const int entry = m_lookup.value(pane, -1);
+    return entry >= 0 && m_entries[entry].pane == pane ? m_entries[entry].rect : QRect();
+}
+
+/**
+ * @brief PaneIndex::neighbour
+ * The pane across \a edge of \a pane. A few points just past the edge are
+ * probed, starting level with the middle of the pane, so the cost does not
+ * depend on the number of panes.
+ */
+Splittable *PaneIndex::neighbour(const Splittable *pane, Qt::Edge edge) const
+{
+    const QRect rect = paneRect(pane);
+    if(rect.isNull())
+        return nullptr;
+
+    const bool horizontal = edge == Qt::LeftEdge || edge == Qt::RightEdge;
+    const int step = edge == Qt::LeftEdge || edge == Qt::TopEdge ? -1 : 1;
+    const QPoint centre = rect.center();
+    const int offsets[] = { 0, -ProbeDistance, ProbeDistance };
+
+    for(int offset : offsets)
+    {
+        for(int distance = 1; distance <= ProbeDistance; ++distance)
+        {
+            QPoint probe;
+            if(horizontal)
+                probe = QPoint((step < 0 ? rect.left() : rect.right()) + step * distance, centre.y() + offset);
+            else
+                probe = QPoint(centre.x() + offset, (step < 0 ? rect.top() : rect.bottom()) + step * distance);
+
+            Splittable *found = paneAt(probe);
+            if(found && found != pane)
+                return found;
+        }
+    }
+    return nullptr;
+}
+
+int PaneIndex::count() const
+{
+    return m_lookup.count();
+}
+
+void PaneIndex::collect(Splittable *pane, const QPoint &origin)
+{
+    if(pane->isHidden())
+        return;
+
+    QSplitter *splitter = pane->splitter();
+    if(!splitter)
+    {
+        insert(pane, QRect(origin, pane->size()));
+        return;
+    }
+
+    const QPoint base = origin + splitter->pos();
+    for(int i = 0; i < splitter->count(); ++i)
+    {
+        if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+            collect(child, base + child->pos());
+    }
+}
+
+void PaneIndex::insert(Splittable *pane, const QRect &rect)
+{
+    remove(pane);
+
+    int entry;
+    if(!m_free.isEmpty())
+    {
+        entry = m_free.takeLast();
+        m_entries[entry] = {pane, rect};
+    }
+    else
+    {
+        entry = m_entries.count();
+        m_entries.append({pane, rect});
+    }
+    m_lookup.insert(pane, entry);
+    place(entry);
+}
+
+void PaneIndex::remove(const Splittable *pane)
+{
+    auto it = m_lookup.find(pane);
+    if(it == m_lookup.end())
+        return;
+
+    const int entry = it.value();
+    m_lookup.erase(it);
+    unplace(entry);
+    m_entries[entry] = Entry();
+    m_free.append(entry);
+}
+
+void PaneIndex::removeSubtree(Splittable *pane)
+{
+    remove(pane);
+    if(QSplitter *splitter = pane->splitter())
+    {
+        for(int i = 0; i < splitter->count(); ++i)
+        {
+            if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+                removeSubtree(child);
+        }
+    }
+}
+
+void PaneIndex::place(int entry)
+{
+    const QRect rect = m_entries[entry].rect.intersected(m_bounds);
+    if(rect.isEmpty())
+        return;
+
+    const int left = (rect.left() - m_bounds.left()) / CellSize;
+    const int right = (rect.right() - m_bounds.left()) / CellSize;
+    const int top = (rect.top() - m_bounds.top()) / CellSize;
+    const int bottom = (rect.bottom() - m_bounds.top()) / CellSize;
+    for(int row = top; row <= bottom; ++row)
+    {
+        for(int column = left; column <= right; ++column)
+            m_cells[row * m_columns + column].append(entry);
+    }
+}
+
+void PaneIndex::unplace(int entry)
+{
+    const QRect rect = m_entries[entry].rect.intersected(m_bounds);
+    if(rect.isEmpty())
+        return;
+
+    const int left = (rect.left() - m_bounds.left()) / CellSize;
+    const int right = (rect.right() - m_bounds.left()) / CellSize;
+    const int top = (rect.top() - m_bounds.top()) / CellSize;
+    const int bottom = (rect.bottom() - m_bounds.top()) / CellSize;
+    for(int row = top; row <= bottom; ++row)
+    {
+        for(int column = left; column <= right; ++column)
+            m_cells[row * m_columns + column].removeOne(entry);
+    }
+}
+
+int PaneIndex::cellAt(const QPoint &pos) const
+{
+    if(!m_bounds.contains(pos))
+        return -1;
+
+    const int column = (pos.x() - m_bounds.left()) / CellSize;
+    const int row = (pos.y() - m_bounds.top()) / CellSize;
+    return row * m_columns + column;
+}
@@ -0,0 +1,68 @@
+#ifndef PANEINDEX_H
+#define PANEINDEX_H
+
+#include <QHash>
+#include <QPointer>
+#include <QRect>
+#include <QVector>
+
+class Splittable;
+
+/**
+ * @brief The PaneIndex class
+ * A uniform grid over the leaf panes of a Splittable tree, in root
+ * coordinates. A point query only tests the few panes overlapping one cell,
+ * however many panes the tree has.
+ *
+ * Panes whose geometry changed are queued with update() and only their
+ * subtrees are collected again on the next refresh(), a resize of the root
+ * rebuilds the whole grid.
+ */
+class PaneIndex
+{
+public:
+    enum { CellSize = 64, MaximumPending = 64, ProbeDistance = 8 };
+
+    PaneIndex();
+
+    void rebuild(Splittable *root);
+    void clear();
+
+    void invalidate();
+    bool isValid() const;
+
+    void update(Splittable *pane);
+    void refresh(Splittable *root);
+
+    Splittable *paneAt(const QPoint &pos, QRect *rect = nullptr) const;
+    QRect paneRect(const Splittable *pane) const;
+    Splittable *neighbour(const Splittable *pane, Qt::Edge edge) const;
+    int count() const;
+
+private:
+    void collect(Splittable *pane, const QPoint &origin);
+    void insert(Splittable *pane, const QRect &rect);
+    void remove(const Splittable *pane);
+    void removeSubtree(Splittable *pane);
+    void place(int entry);
+    void unplace(int entry);
+    int cellAt(const QPoint &pos) const;
+
+    struct Entry
+    {
+        QPointer<Splittable> pane;
+        QRect rect;
+    };
+
+    QVector<Entry> m_entries;
+    QVector<int> m_free;
+    QHash<const Splittable *, int> m_lookup;
+    QVector<QVector<int>> m_cells;
+    QVector<QPointer<Splittable>> m_pending;
+    QRect m_bounds;
+    int m_columns = 0;
+    int m_rows = 0;
+    bool m_valid = false;
+};
+
+#endif // PANEINDEX_H
@@ -0,0 +1,334 @@
+#include "PaneOverview.h"
+#include "PaneRegistry.h"
+#include "Splittable.h"
+#include "Viewport.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QPointer>
+#include <QTimer>
+#include <QtConcurrent>
+#include <QtMath>
+
+class PaneOverviewPrivate
+{
+public:
+    PaneOverviewPrivate(PaneOverview *q) : q_ptr(q) {}
+
+    struct Thumbnail
+    {
+        QPointer<Viewport> viewport;
+        int pane = 0;
+        QImage image;
+        QRect cell;
+        bool dirty = true;
+        bool pending = false;
+    };
+
+    /*
+     * Follow the tree: new viewports get an empty, dirty thumbnail, removed
+     * ones are dropped, the others keep theirs.
+     */
+    void sync()
+    {
+        QHash<Viewport *, Thumbnail> previous;
+        previous.swap(thumbnails);
+        order.clear();
+        if(!root)
+            return;
+
+        const QList<int> panes = root->registry()->panes();
+        for(int id : panes)
+        {
+            Splittable *pane = root->registry()->pane(id);
+            auto viewport = pane ? qobject_cast<Viewport *>(pane->widget()) : nullptr;
+            if(!viewport)
+                continue;
+
+            Thumbnail thumbnail = previous.take(viewport);
+            thumbnail.viewport = viewport;
+            thumbnail.pane = id;
+            thumbnails.insert(viewport, thumbnail);
+            order.append(viewport);
+        }
+        layoutCells();
+    }
+
+    void layoutCells()
+    {
+        const int count = order.count();
+        if(count == 0)
+            return;
+
+        const QRect area = q_ptr->rect().adjusted(Spacing, Spacing, -Spacing, -Spacing);
+        const int columns = qMax(1, qCeil(qSqrt(count * qreal(area.width()) / qMax(1, area.height()))));
+        const int rows = (count + columns - 1) / columns;
+        const int width = (area.width() - (columns - 1) * Spacing) / columns;
+        const int height = (area.height() - (rows - 1) * Spacing) / rows;
+        for(int i = 0; i < count; ++i)
+        {
+            const int column = i % columns;
+            const int row = i / columns;
+            thumbnails[order[i]].cell = QRect(area.left() + column * (width + Spacing),
+                                              area.top() + row * (height + Spacing), width, height);
+        }
+    }
+
+    /*
+     * Grab dirty viewports until the frame budget is spent, the pixmap is
+     * handed to a worker thread to be scaled down.
+     */
+    void grabSome()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        bool remaining = false;
+        for(Viewport *viewport : qAsConst(order))
+        {
+            Thumbnail &thumbnail = thumbnails[viewport];
+            if(!thumbnail.dirty || thumbnail.pending || !thumbnail.viewport)
+                continue;
+            if(timer.elapsed() >= PaneOverview::FrameBudget)
+            {
+                remaining = true;
+                break;
+            }
+
+            grabbing = true;
+            const QImage image = viewport->grab().toImage();
+            grabbing = false;
+            thumbnail.dirty = false;
+            thumbnail.pending = true;
+            scale(viewport, image);
+        }
+
+        if(!remaining)
+            grabTimer->stop();
+    }
+
+    void scale(Viewport *viewport, const QImage &image)
+    {
+        auto watcher = new QFutureWatcher<QImage>(q_ptr);
+        QObject::connect(watcher, &QFutureWatcher<QImage>::finished, q_ptr, [this, watcher, viewport] {
+            watcher->deleteLater();
+            auto it = thumbnails.find(viewport);
+            if(it == thumbnails.end())
+                return;
+            it->pending = false;
+            it->image = watcher->result();
+            q_ptr->update(it->cell);
+            // painted again while it was being scaled
+            if(it->dirty && q_ptr->isVisible())
+                grabTimer->start();
+        });
+        watcher->setFuture(QtConcurrent::run([image] {
+            return image.scaled(PaneOverview::ThumbnailWidth, PaneOverview::ThumbnailHeight,
+                                Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }));
+    }
+
+    Viewport *viewportOf(QWidget *widget) const
+    {
+        for(; widget && widget != root; widget = widget->parentWidget())
+        {
+            if(auto viewport = qobject_cast<Viewport *>(widget))
+                return viewport;
+        }
+        return nullptr;
+    }
+
+    int cellAt(const QPoint &pos) const
+    {
+        for(int i = 0; i < order.count(); ++i)
+        {
+            if(thumbnails.value(order[i]).cell.contains(pos))
+                return i;
+        }
+        return -1;
+    }
+
+    enum { Spacing = 12 };
+
+    PaneOverview *q_ptr;
+    QPointer<Splittable> root;
+    QHash<Viewport *, Thumbnail> thumbnails;
+    QVector<Viewport *> order;
+    QTimer *grabTimer = nullptr;
+    bool grabbing = false;
+    int hovered = -1;
+};
+
+/**
+ * @brief PaneOverview::PaneOverview
+ * @param root the tree to show
+ * @param parent the parent of \a root, the overview covers the root in it
+ */
+PaneOverview::PaneOverview(Splittable *root, QWidget *parent)
+    : QWidget(parent)
+    , d(new PaneOverviewPrivate(this))
+{
+    d->root = root;
+    d->grabTimer = new QTimer(this);
+    d->grabTimer->setInterval(0);
+    connect(d->grabTimer, &QTimer::timeout, this, [this] { d->grabSome(); });
+
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMouseTracking(true);
+    setFocusPolicy(Qt::StrongFocus);
+    hide();
+
+    /* Thumbnails are kept between openings, only repainted viewports are
+     * grabbed again. Paints are watched application wide, but only while the
+     * tree is shown: a hidden tree does not paint. */
+    if(root)
+    {
+        root->installEventFilter(this);
+        if(root->isVisible())
+            qApp->installEventFilter(this);
+    }
+}
+
+PaneOverview::~PaneOverview()
+{
+    if(qApp)
+        qApp->removeEventFilter(this);
+}
+
+Splittable *PaneOverview::root() const
+{
+    return d->root;
+}
+
+void PaneOverview::open()
+{
+    if(!d->root)
+        return;
+
+    setGeometry(QRect(d->root->mapTo(parentWidget(), QPoint(0, 0)), d->root->size()));
+    d->sync();
+    d->hovered = -1;
+    raise();
+    show();
+    setFocus(Qt::OtherFocusReason);
+    d->grabTimer->start();
+}
+
+/**
+ * @brief PaneOverview::pendingThumbnails
+ * @return the number of thumbnails waiting to be grabbed or scaled
+ */
+int PaneOverview::pendingThumbnails() const
+{
+    int count = 0;
+    for(const PaneOverviewPrivate::Thumbnail &thumbnail : qAsConst(d->thumbnails))
+    {
+        if(thumbnail.viewport && (thumbnail.dirty || thumbnail.pending))
+            ++count;
+    }
+    return count;
+}
+
+void PaneOverview::toggle()
+{
+    if(isVisible())
+        hide();
+    else
+        open();
+}
+
+/**
+ * @brief PaneOverview::eventFilter
+ * A paint event of any widget inside a viewport marks its thumbnail dirty.
+ * Paints caused by our own grabs are ignored. The application wide filter
+ * follows the visibility of the root.
+ */
+bool PaneOverview::eventFilter(QObject *watched, QEvent *event)
+{
+    if(watched == d->root && (event->type() == QEvent::Show || event->type() == QEvent::Hide))
+    {
+        qApp->removeEventFilter(this);
+        if(event->type() == QEvent::Show)
+            qApp->installEventFilter(this);
+    }
+    else if(event->type() == QEvent::Paint && !d->grabbing && watched != this && watched->isWidgetType()
+            && !d->thumbnails.isEmpty())
+    {
+        auto it = d->thumbnails.find(d->viewportOf(static_cast<QWidget *>(watched)));
+        if(it != d->thumbnails.end() && !it->dirty)
+        {
+            it->dirty = true;
+            if(isVisible() && !d->grabTimer->isActive())
+                d->grabTimer->start();
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void PaneOverview::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), QColor("#222222"));
+
+    for(int i = 0; i < d->order.count(); ++i)
+    {
+        const PaneOverviewPrivate::Thumbnail &thumbnail = d->thumbnails[d->order[i]];
+        if(!thumbnail.cell.intersects(event->rect()))
+            continue;
+
+        painter.fillRect(thumbnail.cell, QColor("#333333"));
+        if(!thumbnail.image.isNull())
+        {
+            QSize size = thumbnail.image.size();
+            size.scale(thumbnail.cell.size(), Qt::KeepAspectRatio);
+            QRect target(QPoint(0, 0), size);
+            target.moveCenter(thumbnail.cell.center());
+            painter.drawImage(target, thumbnail.image);
+        }
+
+        painter.setPen(QColor(i == d->hovered ? "#ffffff" : "#999999"));
+        painter.drawRect(thumbnail.cell.adjusted(0, 0, -1, -1));
+    }
+}
+
+void PaneOverview::mouseMoveEvent(QMouseEvent *event)
+{
+    const int hovered = d->cellAt(event->pos());
+    if(hovered == d->hovered)
+        return;
+
+    if(d->hovered >= 0)
+        update(d->thumbnails.value(d->order.value(d->hovered)).cell);
+    d->hovered = hovered;
+    if(hovered >= 0)
+        update(d->thumbnails.value(d->order[hovered]).cell);
+}
+
+void PaneOverview::mouseReleaseEvent(QMouseEvent *event)
+{
+    const int cell = event->button() == Qt::LeftButton ? d->cellAt(event->pos()) : -1;
+    if(cell < 0)
+        return QWidget::mouseReleaseEvent(event);
+
+    const int pane = d->thumbnails.value(d->order[cell]).pane;
+    hide();
+    if(d->root)
+        d->root->registry()->focusPane(pane);
+    emit paneSelected(pane);
+}
+
+void PaneOverview::keyPressEvent(QKeyEvent *event)
+{
+    if(event->key() == Qt::Key_Escape)
+        return hide();
+    QWidget::keyPressEvent(event);
+}
+
+void PaneOverview::resizeEvent(QResizeEvent *event)
+{
+    d->layoutCells();
+    QWidget::resizeEvent(event);
+}
@@ -0,0 +1,49 @@
+#ifndef PANEOVERVIEW_H
+#define PANEOVERVIEW_H
+
+#include <QWidget>
+
+class Splittable;
+
+class PaneOverviewPrivate;
+
+/**
+ * @brief The PaneOverview class
+ * Covers a Splittable tree with scaled thumbnails of all its viewports, a
+ * click focuses the pane under it. Thumbnails are kept between openings and
+ * grabbed again only for viewports that painted since their last capture, a
+ * few per frame. The grabs are scaled down on a worker thread.
+ */
+class PaneOverview : public QWidget
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE_D(d, PaneOverview)
+public:
+    enum { FrameBudget = 4, ThumbnailWidth = 320, ThumbnailHeight = 240 };
+
+    explicit PaneOverview(Splittable *root, QWidget *parent = nullptr);
+    ~PaneOverview() override;
+
+    Splittable *root() const;
+
+    void open();
+    void toggle();
+
+    int pendingThumbnails() const;
+
+signals:
+    void paneSelected(int id);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    QScopedPointer<PaneOverviewPrivate> d;
+};
+
+#endif // PANEOVERVIEW_H
@@ -0,0 +1,337 @@
+#include "PaneRegistry.h"
+#include "SplitController.h"
+#include "Splittable.h"
+#include "Viewport.h"
+
+#include <QHash>
+#include <QMultiHash>
+#include <QPointer>
+#include <QSplitter>
+#include <QVector>
+
+class PaneRegistryPrivate
+{
+public:
+    PaneRegistryPrivate(PaneRegistry *q) : q_ptr(q) {}
+
+    /*
+     * One walk over the tree fills every table. Only called when a query
+     * finds the tables dirty, so a burst of splits costs a single walk.
+     */
+    void sync()
+    {
+        if(!dirty)
+            return;
+
+        panes.clear();
+        leaves.clear();
+        positions.clear();
+        keys.clear();
+        dirty = false;
+        if(root)
+            collect(root);
+    }
+
+    void collect(Splittable *pane)
+    {
+        panes.insert(pane->paneId(), pane);
+        if(QSplitter *splitter = pane->splitter())
+        {
+            for(int i = 0; i < splitter->count(); ++i)
+            {
+                if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+                    collect(child);
+            }
+            return;
+        }
+
+        positions.insert(pane->paneId(), leaves.count());
+        leaves.append(pane->paneId());
+        if(auto viewport = qobject_cast<Viewport *>(pane->widget()))
+        {
+            QObject::connect(viewport, &Viewport::contentChanged, q_ptr, &PaneRegistry::invalidate,
+                             Qt::UniqueConnection);
+            const QString key = viewport->content().key();
+            if(!key.isEmpty())
+                keys.insert(key, pane->paneId());
+        }
+    }
+
+    /*
+     * The rows the model serves. They are only rebuilt after a model reset
+     * was announced, so attached views never see the live tree change under
+     * them.
+     */
+    void syncRows()
+    {
+        if(!rowsDirty)
+            return;
+
+        nodes.clear();
+        rootId = 0;
+        rowsDirty = false;
+        if(root)
+        {
+            rootId = root->paneId();
+            snapshot(root, 0, 0);
+        }
+    }
+
+    void snapshot(Splittable *pane, int parent, int row)
+    {
+        Node node;
+        node.parent = parent;
+        node.row = row;
+        if(QSplitter *splitter = pane->splitter())
+        {
+            for(int i = 0; i < splitter->count(); ++i)
+            {
+                if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+                {
+                    snapshot(child, pane->paneId(), node.children.count());
+                    node.children.append(child->paneId());
+                }
+            }
+        }
+        nodes.insert(pane->paneId(), node);
+    }
+
+    PaneRegistry *q_ptr;
+    QPointer<Splittable> root;
+    QHash<int, QPointer<Splittable>> panes;
+    QMultiHash<QString, int> keys;
+    QList<int> leaves;
+    QHash<int, int> positions;
+    bool dirty = true;
+
+    struct Node
+    {
+        int parent = 0;
+        int row = 0;
+        QVector<int> children;
+    };
+    QHash<int, Node> nodes;
+    int rootId = 0;
+    bool rowsDirty = true;
+
+    int updating = 0;
+    bool changed = false;
+};
+
+/**
+ * @brief PaneRegistry::PaneRegistry
+ * @param root the root of the tree, which owns the registry
+ */
+PaneRegistry::PaneRegistry(Splittable *root)
+    : QAbstractItemModel(root)
+    , d(new PaneRegistryPrivate(this))
+{
+    d->root = root;
+}
+
+PaneRegistry::~PaneRegistry()
+{
+
+}
+
+Splittable *PaneRegistry::root() const
+{
+    return d->root;
+}
+
+Splittable *PaneRegistry::pane(int id) const
+{
+    d->sync();
+    return d->panes.value(id);
+}
+
+/**
+ * @brief PaneRegistry::panes
+ * @return the ids of the leaf panes, in tree order
+ */
+QList<int> PaneRegistry::panes() const
+{
+    d->sync();
+    return d->leaves;
+}
+
+/**
+ * @brief PaneRegistry::nextPane
+ * @return the id of the leaf pane \a step places after \a id in tree order,
+ * wrapping around, or 0 if \a id is not a leaf pane
+ */
+int PaneRegistry::nextPane(int id, int step) const
+{
+    d->sync();
+    const int position = d->positions.value(id, -1);
+    if(position < 0)
+        return 0;
+
+    const int count = d->leaves.count();
+    return d->leaves.at(((position + step) % count + count) % count);
+}
+
+QList<Splittable *> PaneRegistry::panesShowing(const QString &key) const
+{
+    d->sync();
+    QList<Splittable *> result;
+    for(auto it = d->keys.constFind(key); it != d->keys.constEnd() && it.key() == key; ++it)
+    {
+        if(Splittable *pane = d->panes.value(it.value()))
+            result.prepend(pane);
+    }
+    return result;
+}
+
+Splittable *PaneRegistry::paneAt(const QPoint &pos) const
+{
+    SplitController *controller = d->root ? d->root->controller() : nullptr;
+    return controller ? controller->paneAt(pos) : nullptr;
+}
+
+bool PaneRegistry::focusPane(int id)
+{
+    Splittable *target = pane(id);
+    QWidget *widget = target ? target->widget() : nullptr;
+    if(!widget)
+        return false;
+
+    // prefer the widget that last had focus inside the pane
+    QWidget *focus = widget->focusWidget();
+    (focus && widget->isAncestorOf(focus) ? focus : widget)->setFocus(Qt::OtherFocusReason);
+    return true;
+}
+
+QModelIndex PaneRegistry::indexOf(int id) const
+{
+    d->syncRows();
+    auto it = d->nodes.constFind(id);
+    return it != d->nodes.constEnd() ? createIndex(it->row, 0, quintptr(id)) : QModelIndex();
+}
+
+Splittable *PaneRegistry::paneOf(const QModelIndex &index) const
+{
+    return index.isValid() ? pane(int(index.internalId())) : nullptr;
+}
+
+/**
+ * @brief PaneRegistry::invalidate
+ * Called when panes were split, unsplit or got other content. The lookup
+ * tables are rebuilt lazily. The model rows are a snapshot, they are only
+ * rebuilt inside the announced reset, and a reset is skipped while no view
+ * read the rows since the last one.
+ */
+void PaneRegistry::invalidate()
+{
+    d->dirty = true;
+    if(d->updating > 0)
+    {
+        d->changed = true;
+        return;
+    }
+    if(d->rowsDirty)
+        return;
+
+    beginResetModel();
+    d->rowsDirty = true;
+    endResetModel();
+}
+
+/**
+ * @brief PaneRegistry::beginUpdate
+ * Changes until the matching endUpdate() keep the tables up to date but
+ * reset the model only once, at the end.
+ */
+void PaneRegistry::beginUpdate()
+{
+    ++d->updating;
+}
+
+void PaneRegistry::endUpdate()
+{
+    Q_ASSERT(d->updating > 0);
+    if(--d->updating > 0 || !d->changed)
+        return;
+
+    d->changed = false;
+    if(d->rowsDirty)
+        return;
+
+    beginResetModel();
+    d->rowsDirty = true;
+    endResetModel();
+}
+
+QModelIndex PaneRegistry::index(int row, int column, const QModelIndex &parent) const
+{
+    if(column != 0 || row < 0)
+        return QModelIndex();
+
+    d->syncRows();
+    if(!parent.isValid())
+        return row == 0 && d->rootId ? createIndex(0, 0, quintptr(d->rootId)) : QModelIndex();
+
+    const QVector<int> children = d->nodes.value(int(parent.internalId())).children;
+    return row < children.count() ? createIndex(row, 0, quintptr(children[row])) : QModelIndex();
+}
+
+QModelIndex PaneRegistry::parent(const QModelIndex &child) const
+{
+    if(!child.isValid())
+        return QModelIndex();
+
+    d->syncRows();
+    const int parent = d->nodes.value(int(child.internalId())).parent;
+    auto it = d->nodes.constFind(parent);
+    return it != d->nodes.constEnd() ? createIndex(it->row, 0, quintptr(parent)) : QModelIndex();
+}
+
+int PaneRegistry::rowCount(const QModelIndex &parent) const
+{
+    d->syncRows();
+    if(!parent.isValid())
+        return d->rootId ? 1 : 0;
+
+    return d->nodes.value(int(parent.internalId())).children.count();
+}
+
+int PaneRegistry::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return 1;
+}
+
+QVariant PaneRegistry::data(const QModelIndex &index, int role) const
+{
+    Splittable *pane = paneOf(index);
+    if(!pane)
+        return QVariant();
+
+    auto viewport = qobject_cast<Viewport *>(pane->widget());
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        if(pane->splitter())
+            return pane->splitter()->orientation() == Qt::Horizontal ? tr("Horizontal") : tr("Vertical");
+        if(viewport && !viewport->content().title().isEmpty())
+            return viewport->content().title();
+        return tr("Pane %1").arg(pane->paneId());
+    case PaneIdRole:
+        return pane->paneId();
+    case ContentKeyRole:
+        return viewport ? viewport->content().key() : QString();
+    case OrientationRole:
+        return pane->splitter() ? QVariant(int(pane->splitter()->orientation())) : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> PaneRegistry::roleNames() const
+{
+    QHash<int, QByteArray> names = QAbstractItemModel::roleNames();
+    names.insert(PaneIdRole, "paneId");
+    names.insert(ContentKeyRole, "contentKey");
+    names.insert(OrientationRole, "orientation");
+    return names;
+}
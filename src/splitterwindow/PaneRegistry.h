@@ -0,0 +1,62 @@
+#ifndef PANEREGISTRY_H
+#define PANEREGISTRY_H
+
+#include <QAbstractItemModel>
+
+class Splittable;
+
+class PaneRegistryPrivate;
+
+/**
+ * @brief The PaneRegistry class
+ * Addresses the panes of a Splittable tree by their stable ids and exposes
+ * the tree as an item model. The id and content lookups are hashed, point
+ * lookups go through the PaneIndex grid of the tree's SplitController.
+ *
+ * The tables are rebuilt by one walk on the first query after the tree
+ * changed, never per query. The model rows are a snapshot of the tree taken
+ * after each reset, not the live tree.
+ */
+class PaneRegistry : public QAbstractItemModel
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE_D(d, PaneRegistry)
+public:
+    enum Roles
+    {
+        PaneIdRole = Qt::UserRole + 1,
+        ContentKeyRole,
+        OrientationRole
+    };
+
+    explicit PaneRegistry(Splittable *root);
+    ~PaneRegistry() override;
+
+    Splittable *root() const;
+
+    Splittable *pane(int id) const;
+    QList<int> panes() const;
+    int nextPane(int id, int step = 1) const;
+    QList<Splittable *> panesShowing(const QString &key) const;
+    Splittable *paneAt(const QPoint &pos) const;
+    bool focusPane(int id);
+
+    QModelIndex indexOf(int id) const;
+    Splittable *paneOf(const QModelIndex &index) const;
+
+    void invalidate();
+    void beginUpdate();
+    void endUpdate();
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+private:
+    QScopedPointer<PaneRegistryPrivate> d;
+};
+
+#endif // PANEREGISTRY_H
@@ -0,0 +1,64 @@
+#include "SnapshotCover.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+SnapshotCover::SnapshotCover(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    hide();
+}
+
+void SnapshotCover::clear()
+{
+    m_snapshots.clear();
+    m_handle = QRect();
+}
+
+int SnapshotCover::addSnapshot(const QPixmap &pixmap, const QRect &rect)
+{
+    m_snapshots.append({pixmap, rect});
+    update(rect);
+    return m_snapshots.count() - 1;
+}
+
+void SnapshotCover::setSnapshotRect(int index, const QRect &rect)
+{
+    Q_ASSERT(index >= 0 && index < m_snapshots.count());
+    if(m_snapshots[index].rect == rect)
+        return;
+
+    update(m_snapshots[index].rect.united(rect));
+    m_snapshots[index].rect = rect;
+}
+
+void SnapshotCover::setHandleRect(const QRect &rect)
+{
+    if(m_handle == rect)
+        return;
+
+    update(m_handle.united(rect));
+    m_handle = rect;
+}
+
+void SnapshotCover::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), QColor("#333333"));
+
+    for(const Snapshot &snapshot : qAsConst(m_snapshots))
+    {
+        if(!snapshot.rect.intersects(event->rect()))
+            continue;
+
+        painter.save();
+        painter.setClipRect(snapshot.rect);
+        painter.drawPixmap(snapshot.rect.topLeft(), snapshot.pixmap);
+        painter.restore();
+    }
+
+    if(!m_handle.isEmpty())
+        painter.fillRect(m_handle, QColor("#999999"));
+}
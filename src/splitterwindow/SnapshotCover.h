@@ -0,0 +1,40 @@
+#ifndef SNAPSHOTCOVER_H
+#define SNAPSHOTCOVER_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QVector>
+
+/**
+ * @brief The SnapshotCover class
+ * Covers live panes with pixmaps grabbed once, while a drag or a window
+ * resize is in progress. Each snapshot is cropped to its current rectangle,
+ * uncovered space is filled with the pane background, so the real content
+ * only has to be laid out again when the gesture ends.
+ */
+class SnapshotCover : public QWidget
+{
+public:
+    explicit SnapshotCover(QWidget *parent = nullptr);
+
+    void clear();
+    int addSnapshot(const QPixmap &pixmap, const QRect &rect);
+    void setSnapshotRect(int index, const QRect &rect);
+
+    void setHandleRect(const QRect &rect);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Snapshot
+    {
+        QPixmap pixmap;
+        QRect rect;
+    };
+
+    QVector<Snapshot> m_snapshots;
+    QRect m_handle;
+};
+
+#endif // SNAPSHOTCOVER_H
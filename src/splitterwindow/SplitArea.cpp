@@ -0,0 +1,648 @@
+#include "SplitArea.h"
+
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPointer>
+#include <QVarLengthArray>
+#include <QHash>
+#include <QVector>
+
+/*
+ * Nodes are stored in pre-order: a branch is followed by its children, each
+ * child by its own subtree. The rectangle of a branch is always known before
+ * its children are visited, so one forward pass lays out the whole tree.
+ *
+ * [0] branch H ─┬─ [1] pane
+ *               ├─ [2] branch V ─┬─ [3] pane
+ *               │                └─ [4] pane
+ *               └─ [5] pane
+ */
+struct SplitNode
+{
+    int id = -1;
+    int children = 0;               // 0 for a pane
+    Qt::Orientation orientation = Qt::Horizontal;
+    qreal ratio = 1.0;              // share of the parent's extent
+    QSize minimumSize;              // panes only
+    QPointer<QWidget> widget;       // panes only
+
+    // derived, see SplitAreaPrivate::rebuild()
+    int parent = -1;
+    int subtree = 1;
+    QSize effectiveMinimum;
+
+    // derived, see SplitAreaPrivate::layout()
+    QRect rect;
+};
+
+struct SplitHandle
+{
+    int node;   // the branch
+    int first;  // child before the handle
+    int second; // child after the handle
+    QRect rect;
+};
+
+class SplitAreaPrivate
+{
+    Q_DECLARE_PUBLIC(SplitArea)
+public:
+    SplitAreaPrivate(SplitArea *q) : q_ptr(q) {}
+
+    inline int pick(Qt::Orientation orientation, const QPoint &pos) const
+    { return orientation == Qt::Horizontal ? pos.x() : pos.y(); }
+
+    inline int pick(Qt::Orientation orientation, const QSize &size) const
+    { return orientation == Qt::Horizontal ? size.width() : size.height(); }
+
+    int indexOf(int pane) const
+    {
+        return indexes.value(pane, -1);
+    }
+
+    /*
+     * Recompute parents, subtree sizes, effective minimum sizes and the id
+     * index after a structural change, one forward and one backward pass.
+     */
+    void rebuild()
+    {
+        const int count = nodes.count();
+        indexes.clear();
+        indexes.reserve(count);
+
+        QVarLengthArray<QPair<int, int>, 32> stack; // branch, children left
+        for(int i = 0; i < count; ++i)
+        {
+            while(!stack.isEmpty() && stack.last().second == 0)
+                stack.removeLast();
+
+            SplitNode &node = nodes[i];
+            node.parent = stack.isEmpty() ? -1 : stack.last().first;
+            node.subtree = 1;
+            if(!stack.isEmpty())
+                --stack.last().second;
+            if(node.children > 0)
+                stack.append(qMakePair(i, node.children));
+
+            if(node.children == 0)
+                node.effectiveMinimum = node.minimumSize.expandedTo(QSize(0, 0));
+            else
+                node.effectiveMinimum = node.orientation == Qt::Horizontal
+                        ? QSize(-handleWidth, 0) : QSize(0, -handleWidth);
+
+            indexes.insert(node.id, i);
+        }
+
+        // children come after their parent, walking backwards folds them up
+        for(int i = count - 1; i > 0; --i)
+        {
+            const SplitNode &node = nodes[i];
+            SplitNode &parent = nodes[node.parent];
+            parent.subtree += node.subtree;
+
+            const QSize minimum = node.effectiveMinimum;
+            if(parent.orientation == Qt::Horizontal)
+            {
+                parent.effectiveMinimum.rwidth() += minimum.width() + handleWidth;
+                parent.effectiveMinimum.rheight() = qMax(parent.effectiveMinimum.height(), minimum.height());
+            }
+            else
+            {
+                parent.effectiveMinimum.rheight() += minimum.height() + handleWidth;
+                parent.effectiveMinimum.rwidth() = qMax(parent.effectiveMinimum.width(), minimum.width());
+            }
+        }
+    }
+
+    /*
+     * Raise children below their minimum and take the deficit from the
+     * others in proportion to their slack, with integer error diffusion.
+     */
+    static void constrain(QVarLengthArray<int, 16> &sizes, const QVarLengthArray<int, 16> &minimums)
+    {
+        int deficit = 0;
+        int slack = 0;
+        for(int k = 0; k < sizes.count(); ++k)
+        {
+            if(sizes[k] < minimums[k])
+            {
+                deficit += minimums[k] - sizes[k];
+                sizes[k] = minimums[k];
+            }
+            else
+            {
+                slack += sizes[k] - minimums[k];
+            }
+        }
+
+        if(deficit == 0 || slack == 0)
+            return;
+
+        const int take = qMin(deficit, slack);
+        qint64 error = 0;
+        for(int k = 0; k < sizes.count(); ++k)
+        {
+            const int room = sizes[k] - minimums[k];
+            if(room <= 0)
+                continue;
+            const qint64 scaled = qint64(room) * take + error;
+            const int cut = int(scaled / slack);
+            error = scaled - qint64(cut) * slack;
+            sizes[k] -= cut;
+        }
+    }
+
+    /*
+     * One forward pass over the node array: every branch distributes its
+     * rectangle over its children, handles are collected on the way.
+     */
+    void layout()
+    {
+        handles.clear();
+        if(nodes.isEmpty())
+            return;
+
+        nodes[0].rect = q_ptr->rect();
+
+        QVarLengthArray<int, 16> children;
+        QVarLengthArray<int, 16> sizes;
+        QVarLengthArray<int, 16> minimums;
+        for(int i = 0; i < nodes.count(); ++i)
+        {
+            const SplitNode &node = nodes[i];
+            if(node.children == 0)
+                continue;
+
+            const Qt::Orientation orientation = node.orientation;
+            const QRect rect = node.rect;
+            const int extent = qMax(0, pick(orientation, rect.size()) - (node.children - 1) * handleWidth);
+
+            children.clear();
+            sizes.clear();
+            minimums.clear();
+
+            qreal total = 0;
+            for(int child = i + 1, k = 0; k < node.children; child += nodes[child].subtree, ++k)
+            {
+                children.append(child);
+                total += nodes[child].ratio;
+            }
+
+            // cumulative rounding keeps the children summing up to the extent
+            qreal cumulative = 0;
+            int previous = 0;
+            for(int k = 0; k < children.count(); ++k)
+            {
+                const SplitNode &child = nodes[children[k]];
+                cumulative += total > 0 ? child.ratio / total : 1.0 / children.count();
+                const int edge = k == children.count() - 1 ? extent : qRound(cumulative * extent);
+                sizes.append(qMax(0, edge - previous));
+                minimums.append(pick(orientation, child.effectiveMinimum));
+                previous = edge;
+            }
+            constrain(sizes, minimums);
+
+            int position = orientation == Qt::Horizontal ? rect.left() : rect.top();
+            for(int k = 0; k < children.count(); ++k)
+            {
+                SplitNode &child = nodes[children[k]];
+                child.rect = orientation == Qt::Horizontal
+                        ? QRect(position, rect.top(), sizes[k], rect.height())
+                        : QRect(rect.left(), position, rect.width(), sizes[k]);
+                position += sizes[k];
+
+                if(k < children.count() - 1)
+                {
+                    const QRect handle = orientation == Qt::Horizontal
+                            ? QRect(position, rect.top(), handleWidth, rect.height())
+                            : QRect(rect.left(), position, rect.width(), handleWidth);
+                    handles.append({i, children[k], children[k + 1], handle});
+                    position += handleWidth;
+                }
+            }
+        }
+    }
+
+    /*
+     * Apply all pane geometries as one batch with updates disabled, so the
+     * area repaints once instead of once per pane.
+     */
+    void apply()
+    {
+        const bool updates = q_ptr->updatesEnabled();
+        q_ptr->setUpdatesEnabled(false);
+        for(const SplitNode &node : qAsConst(nodes))
+        {
+            if(node.children == 0 && node.widget && node.widget->geometry() != node.rect)
+                node.widget->setGeometry(node.rect);
+        }
+        q_ptr->setUpdatesEnabled(updates);
+        q_ptr->update();
+    }
+
+    void relayout()
+    {
+        layout();
+        apply();
+    }
+
+    int handleAt(const QPoint &pos) const
+    {
+        for(int i = 0; i < handles.count(); ++i)
+        {
+            if(handles[i].rect.contains(pos))
+                return i;
+        }
+        return -1;
+    }
+
+    void moveHandle(int index, int position)
+    {
+        const SplitHandle &handle = handles[index];
+        const Qt::Orientation orientation = nodes[handle.node].orientation;
+        SplitNode &first = nodes[handle.first];
+        SplitNode &second = nodes[handle.second];
+
+        const int start = orientation == Qt::Horizontal ? first.rect.left() : first.rect.top();
+        const int combined = pick(orientation, first.rect.size()) + pick(orientation, second.rect.size());
+        if(combined <= 0)
+            return;
+
+        const int minimum = pick(orientation, first.effectiveMinimum);
+        const int maximum = combined - pick(orientation, second.effectiveMinimum);
+        const int size = qBound(minimum, position - start, qMax(minimum, maximum));
+
+        const qreal ratio = first.ratio + second.ratio;
+        first.ratio = ratio * size / combined;
+        second.ratio = ratio - first.ratio;
+        relayout();
+    }
+
+    void updateCursor(int handle)
+    {
+        if(handle == hoverHandle)
+            return;
+
+        hoverHandle = handle;
+        if(handle < 0)
+            q_ptr->unsetCursor();
+        else
+            q_ptr->setCursor(nodes[handles[handle].node].orientation == Qt::Horizontal
+                             ? Qt::SplitHCursor : Qt::SplitVCursor);
+    }
+
+    SplitArea *q_ptr;
+    QVector<SplitNode> nodes;
+    QVector<SplitHandle> handles;
+    QHash<int, int> indexes; // pane id to node index
+    int nextId = 0;
+    int handleWidth = 1;
+
+    int pressedHandle = -1;
+    int pressedOffset = 0;
+    int hoverHandle = -1;
+};
+
+/**
+ * @brief SplitArea::SplitArea
+ * @param parent
+ */
+SplitArea::SplitArea(QWidget *parent)
+    : QWidget(parent)
+    , d(new SplitAreaPrivate(this))
+{
+    setObjectName("SplitArea");
+    setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
+    setMouseTracking(true);
+}
+
+SplitArea::~SplitArea()
+{
+}
+
+/**
+ * @brief SplitArea::addPane
+ * Set the first pane of an empty area, or append a pane to the top level.
+ * @return the id of the new pane
+ */
+int SplitArea::addPane(QWidget *widget)
+{
+    Q_ASSERT(widget != nullptr);
+
+    if(d->nodes.isEmpty())
+    {
+        SplitNode node;
+        node.id = d->nextId++;
+        node.widget = widget;
+        d->nodes.append(node);
+
+        widget->setParent(this);
+        widget->show();
+        d->rebuild();
+        d->relayout();
+        return node.id;
+    }
+
+    SplitNode &root = d->nodes[0];
+    if(root.children == 0)
+        return split(root.id, Qt::Horizontal, widget, 1);
+
+    // the end of the array is the end of the top level
+    qreal total = 0;
+    for(int child = 1, k = 0; k < root.children; child += d->nodes[child].subtree, ++k)
+        total += d->nodes[child].ratio;
+
+    SplitNode leaf;
+    leaf.id = d->nextId++;
+    leaf.widget = widget;
+    leaf.ratio = total / root.children;
+    root.children++;
+    d->nodes.append(leaf);
+
+    widget->setParent(this);
+    widget->show();
+    d->rebuild();
+    d->relayout();
+    return leaf.id;
+}
+
+/**
+ * @brief SplitArea::split
+ * Split \a pane and place \a widget before (index 0) or after (index 1) it.
+ * Splitting in the direction of the parent adds a sibling, so same-direction
+ * splits never nest.
+ * @return the id of the new pane, -1 if \a pane is not a pane
+ */
+int SplitArea::split(int pane, Qt::Orientation orientation, QWidget *widget, int index)
+{
+    Q_ASSERT(widget != nullptr);
+
+    const int i = d->indexOf(pane);
+    if(i < 0 || d->nodes[i].children != 0)
+        return -1;
+
+    SplitNode leaf;
+    leaf.id = d->nextId++;
+    leaf.widget = widget;
+
+    const int parent = d->nodes[i].parent;
+    if(parent >= 0 && d->nodes[parent].orientation == orientation)
+    {
+        const qreal half = d->nodes[i].ratio / 2;
+        d->nodes[i].ratio = half;
+        leaf.ratio = half;
+        d->nodes[parent].children++;
+        d->nodes.insert(index == 0 ? i : i + 1, leaf);
+    }
+    else
+    {
+        SplitNode origin = d->nodes[i];
+        origin.ratio = 0.5;
+        leaf.ratio = 0.5;
+
+        SplitNode &branch = d->nodes[i];
+        branch.id = d->nextId++;
+        branch.children = 2;
+        branch.orientation = orientation;
+        branch.minimumSize = QSize();
+        branch.widget = nullptr;
+
+        d->nodes.insert(i + 1, index == 0 ? origin : leaf);
+        d->nodes.insert(i + 2, index == 0 ? leaf : origin);
+    }
+
+    widget->setParent(this);
+    widget->show();
+    d->rebuild();
+    d->relayout();
+    return leaf.id;
+}
+
+/**
+ * @brief SplitArea::takePane
+ * Remove \a pane and give its space to its neighbour. A branch left with one
+ * child is collapsed, and merged into its parent when both split in the same
+ * direction.
+ * @return the hidden, unparented widget of the pane
+ */
+QWidget *SplitArea::takePane(int pane)
+{
+    const int i = d->indexOf(pane);
+    if(i < 0 || d->nodes[i].children != 0)
+        return nullptr;
+
+    QWidget *widget = d->nodes[i].widget;
+    const int parent = d->nodes[i].parent;
+    if(parent < 0)
+    {
+        d->nodes.clear();
+    }
+    else
+    {
+        // the previous sibling takes the space, the next one for the first
+        int previous = -1;
+        int next = -1;
+        for(int child = parent + 1, k = 0; k < d->nodes[parent].children; child += d->nodes[child].subtree, ++k)
+        {
+            if(child < i)
+                previous = child;
+            else if(child > i && next < 0)
+                next = child;
+        }
+        const int neighbour = previous >= 0 ? previous : next;
+        d->nodes[neighbour].ratio += d->nodes[i].ratio;
+
+        d->nodes.remove(i);
+        d->nodes[parent].children--;
+
+        if(d->nodes[parent].children == 1)
+        {
+            // the only child replaces the branch
+            const qreal ratio = d->nodes[parent].ratio;
+            const int grandparent = d->nodes[parent].parent;
+            d->nodes.remove(parent);
+            SplitNode &child = d->nodes[parent];
+            child.ratio = ratio;
+
+            if(grandparent >= 0 && child.children > 0
+                    && d->nodes[grandparent].orientation == child.orientation)
+            {
+                // merge the child branch into the grandparent
+                d->rebuild();
+                qreal total = 0;
+                for(int c = parent + 1, k = 0; k < child.children; c += d->nodes[c].subtree, ++k)
+                    total += d->nodes[c].ratio;
+                for(int c = parent + 1, k = 0; k < child.children; c += d->nodes[c].subtree, ++k)
+                    d->nodes[c].ratio = total > 0 ? d->nodes[c].ratio * ratio / total : ratio / child.children;
+                d->nodes[grandparent].children += child.children - 1;
+                d->nodes.remove(parent);
+            }
+        }
+    }
+
+    d->rebuild();
+    d->relayout();
+
+    if(widget)
+    {
+        widget->hide();
+        widget->setParent(nullptr);
+    }
+    return widget;
+}
+
+int SplitArea::count() const
+{
+    int count = 0;
+    for(const SplitNode &node : qAsConst(d->nodes))
+        count += node.children == 0;
+    return count;
+}
+
+QList<int> SplitArea::panes() const
+{
+    QList<int> panes;
+    for(const SplitNode &node : qAsConst(d->nodes))
+    {
+        if(node.children == 0)
+            panes << node.id;
+    }
+    return panes;
+}
+
+QWidget *SplitArea::widget(int pane) const
+{
+    const int i = d->indexOf(pane);
+    return i < 0 ? nullptr : d->nodes[i].widget.data();
+}
+
+QRect SplitArea::paneRect(int pane) const
+{
+    const int i = d->indexOf(pane);
+    return i < 0 ? QRect() : d->nodes[i].rect;
+}
+
+/**
+ * @brief SplitArea::paneAt
+ * Descend from the root, only one child per level is visited.
+ */
+int SplitArea::paneAt(const QPoint &pos) const
+{
+    if(d->nodes.isEmpty() || !d->nodes[0].rect.contains(pos))
+        return -1;
+
+    int i = 0;
+    while(d->nodes[i].children > 0)
+    {
+        int found = -1;
+        for(int child = i + 1, k = 0; k < d->nodes[i].children; child += d->nodes[child].subtree, ++k)
+        {
+            if(d->nodes[child].rect.contains(pos))
+            {
+                found = child;
+                break;
+            }
+        }
+
+        // on a handle
+        if(found < 0)
+            return -1;
+        i = found;
+    }
+
+    return d->nodes[i].id;
+}
+
+void SplitArea::setMinimumPaneSize(int pane, const QSize &size)
+{
+    const int i = d->indexOf(pane);
+    if(i < 0 || d->nodes[i].children != 0 || d->nodes[i].minimumSize == size)
+        return;
+
+    d->nodes[i].minimumSize = size;
+    d->rebuild();
+    d->relayout();
+    updateGeometry();
+}
+
+QSize SplitArea::minimumPaneSize(int pane) const
+{
+    const int i = d->indexOf(pane);
+    return i < 0 ? QSize() : d->nodes[i].minimumSize;
+}
+
+void SplitArea::setHandleWidth(int width)
+{
+    width = qMax(0, width);
+    if(width == d->handleWidth)
+        return;
+
+    d->handleWidth = width;
+    d->rebuild();
+    d->relayout();
+    updateGeometry();
+}
+
+int SplitArea::handleWidth() const
+{
+    return d->handleWidth;
+}
+
+QSize SplitArea::minimumSizeHint() const
+{
+    return d->nodes.isEmpty() ? QSize() : d->nodes[0].effectiveMinimum;
+}
+
+void SplitArea::resizeEvent(QResizeEvent *)
+{
+    d->relayout();
+}
+
+void SplitArea::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QColor color("#999999");
+    for(const SplitHandle &handle : qAsConst(d->handles))
+    {
+        if(handle.rect.intersects(event->rect()))
+            painter.fillRect(handle.rect, color);
+    }
+}
+
+void SplitArea::mousePressEvent(QMouseEvent *event)
+{
+    if(event->button() != Qt::LeftButton)
+        return QWidget::mousePressEvent(event);
+
+    d->pressedHandle = d->handleAt(event->pos());
+    if(d->pressedHandle < 0)
+        return QWidget::mousePressEvent(event);
+
+    const SplitHandle &handle = d->handles[d->pressedHandle];
+    const Qt::Orientation orientation = d->nodes[handle.node].orientation;
+    d->pressedOffset = d->pick(orientation, event->pos()) - d->pick(orientation, handle.rect.topLeft());
+    event->accept();
+}
+
+void SplitArea::mouseMoveEvent(QMouseEvent *event)
+{
+    if(d->pressedHandle >= 0 && (event->buttons() & Qt::LeftButton))
+    {
+        const SplitHandle &handle = d->handles[d->pressedHandle];
+        const Qt::Orientation orientation = d->nodes[handle.node].orientation;
+        d->moveHandle(d->pressedHandle, d->pick(orientation, event->pos()) - d->pressedOffset);
+        return;
+    }
+
+    d->updateCursor(d->handleAt(event->pos()));
+    QWidget::mouseMoveEvent(event);
+}
+
+void SplitArea::mouseReleaseEvent(QMouseEvent *event)
+{
+    if(event->button() == Qt::LeftButton)
+        d->pressedHandle = -1;
+
+    QWidget::mouseReleaseEvent(event);
+}
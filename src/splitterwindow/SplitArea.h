@@ -0,0 +1,53 @@
+#ifndef SPLITAREA_H
+#define SPLITAREA_H
+
+#include <QWidget>
+
+class SplitAreaPrivate;
+
+/**
+ * @brief The SplitArea class
+ * A split layout engine without nested splitter widgets: one widget owns a
+ * flat, pre-ordered array of split nodes and computes every pane and handle
+ * rectangle in a single pass, then applies all pane geometries in one batch.
+ *
+ * Panes are addressed by stable ids returned from addPane() and split().
+ */
+class SplitArea : public QWidget
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE_D(d, SplitArea)
+public:
+    explicit SplitArea(QWidget *parent = nullptr);
+    ~SplitArea() override;
+
+    int addPane(QWidget *widget);
+    int split(int pane, Qt::Orientation orientation, QWidget *widget, int index = 1);
+    QWidget *takePane(int pane);
+
+    int count() const;
+    QList<int> panes() const;
+    QWidget *widget(int pane) const;
+    QRect paneRect(int pane) const;
+    int paneAt(const QPoint &pos) const;
+
+    void setMinimumPaneSize(int pane, const QSize &size);
+    QSize minimumPaneSize(int pane) const;
+
+    void setHandleWidth(int width);
+    int handleWidth() const;
+
+    QSize minimumSizeHint() const override;
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    QScopedPointer<SplitAreaPrivate> d;
+};
+
+#endif // SPLITAREA_H
@@ -0,0 +1,583 @@
+#include "SplitController.h"
+#include "PaneIndex.h"
+#include "PaneRegistry.h"
+#include "Splittable.h"
+
+#include <QApplication>
+#include <QSplitter>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QPointer>
+#include <QShortcut>
+
+/*
+ * Overlay arrow, pointing right before it is rotated for the direction:
+ * (0,0)
+ * +--------------------+
+ * |                    |
+ * |        | \         |
+ * |        |  \        |
+ * |--------+   \       |
+ * |            /       | 1/4, 1/5
+ * |--------+  /        |
+ * |        | /         |
+ * |        |/          |
+ * |                    |
+ * +--------------------+ (width, height)
+ *
+ * The arrows are rendered once per (size bucket, device pixel ratio,
+ * direction) into the pixmap cache, painting the overlay is a fill and a
+ * pixmap blit. One overlay per tree is reused for every gesture.
+ */
+class SplitOverlay : public QWidget
+{
+public:
+    enum { SizeBucket = 64 };
+
+    explicit SplitOverlay(QWidget *parent) : QWidget(parent)
+    {
+        setAttribute(Qt::WA_TransparentForMouseEvents);
+        hide();
+    }
+
+    void setDirection(Qt::ArrowType direction)
+    {
+        if(direction == m_direction)
+            return;
+
+        m_direction = direction;
+        update();
+    }
+
+    static QPixmap arrow(const QSize &size, qreal ratio, Qt::ArrowType direction)
+    {
+        // sizes are bucketed so resizing a pane does not render new arrows
+        const QSize bucket = size.width() >= SizeBucket && size.height() >= SizeBucket
+                ? QSize(size.width() / SizeBucket * SizeBucket, size.height() / SizeBucket * SizeBucket)
+                : size;
+        if(bucket.isEmpty())
+            return QPixmap();
+
+        const QString key = QString("SplitOverlay_%1x%2@%3_%4")
+                .arg(bucket.width()).arg(bucket.height()).arg(ratio).arg(int(direction));
+        QPixmap pixmap;
+        if(QPixmapCache::find(key, &pixmap))
+            return pixmap;
+
+        pixmap = QPixmap(bucket * ratio);
+        pixmap.setDevicePixelRatio(ratio);
+        pixmap.fill(Qt::transparent);
+
+        const bool vertical = direction == Qt::UpArrow || direction == Qt::DownArrow;
+        const QSize box = vertical ? bucket.transposed() : bucket;
+        qreal angle = 0;
+        switch (direction)
+        {
+        case Qt::DownArrow: angle = 90;  break;
+        case Qt::LeftArrow: angle = 180; break;
+        case Qt::UpArrow:   angle = 270; break;
+        default:            break;
+        }
+
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor("#999999"));
+        painter.translate(bucket.width() / 2.0, bucket.height() / 2.0);
+        painter.rotate(angle);
+        painter.translate(-box.width() / 2.0, -box.height() / 2.0);
+
+        int offsetX = box.width() / 4;
+        int offsetY = box.height() / 5;
+        QPolygon basePoly;
+        basePoly << QPoint(3 * offsetX, box.height() / 2)
+
+                 << QPoint(2 * offsetX, 4 * offsetY)
+                 << QPoint(2 * offsetX, 3 * offsetY)
+                 << QPoint(0, 3 * offsetY)
+
+                 << QPoint(0, 2 * offsetY)
+                 << QPoint(2 * offsetX, 2 * offsetY)
+                 << QPoint(2 * offsetX, offsetY);
+
+        painter.drawPolygon(basePoly);
+        painter.end();
+
+        QPixmapCache::insert(key, pixmap);
+        return pixmap;
+    }
+
+protected:
+    void paintEvent(QPaintEvent */*event*/) override
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), QColor(0, 0, 0, 127));
+
+        const QPixmap pixmap = arrow(size(), devicePixelRatioF(), m_direction);
+        if(pixmap.isNull())
+            return;
+
+        QRect target(QPoint(), pixmap.size() / pixmap.devicePixelRatio());
+        target.moveCenter(rect().center());
+        painter.drawPixmap(target, pixmap);
+    }
+
+private:
+    Qt::ArrowType m_direction = Qt::RightArrow;
+};
+
+class SplitControllerPrivate
+{
+    Q_DECLARE_PUBLIC(SplitController)
+public:
+    enum MoveDirection
+    {
+        NoMove = -1,
+        MoveLeft = 0,// West
+        MoveRight,  // East
+        MoveUp,     // North
+        MoveDown    // South
+    };
+
+    SplitControllerPrivate(SplitController *q) : q_ptr(q) {}
+
+    static int mouseMoveDirection(const QPoint start, const QPoint &end)
+    {
+        enum DirectionMask
+        {
+            Left    = 0x0001,
+            Top     = 0x0010,
+            Right   = 0x0100,
+            Bottom  = 0x1000,
+        };
+
+        const auto direction =
+                Left    * (end.x() < start.x()) |
+                Right   * (end.x() > start.x()) |
+                Top     * (end.y() < start.y()) |
+                Bottom  * (end.y() > start.y());
+
+        QPoint point = end - start;
+        const int deltaX = qAbs(point.x());
+        const int deltaY = qAbs(point.y());
+
+        switch (direction)
+        {
+        case Left:          return MoveLeft;
+        case Top:           return MoveUp;
+        case Right:         return MoveRight;
+        case Bottom:        return MoveDown;
+        case Left | Top:    return deltaX >= deltaY ? MoveLeft  : MoveUp;   // default left if 45 degree
+        case Left | Bottom: return deltaX >= deltaY ? MoveLeft  : MoveDown;
+        case Right | Top:   return deltaX >= deltaY ? MoveRight : MoveUp;   // default right if 45 degree
+        case Right | Bottom:return deltaX >= deltaY ? MoveRight : MoveDown;
+        }
+
+        return NoMove;
+    }
+
+    /*
+     * Moving out of the left-top corner offers to join the pane with its
+     * previous neighbour, the overlay marks the neighbour that would be
+     * removed while the cursor is over it and release confirms.
+     */
+    void holdUnsplit(Splittable *pane, int direction)
+    {
+        auto splitter = qobject_cast<QSplitter *>(pane->parentWidget());
+        const Qt::Orientation orientation = direction == MoveLeft ? Qt::Horizontal : Qt::Vertical;
+        if(!splitter || splitter->orientation() != orientation)
+            return;
+
+        const int index = splitter->indexOf(pane);
+        if(index <= 0)
+            return;
+
+        unsplitTarget = splitter->widget(index - 1);
+        if(!overlay)
+            overlay = new SplitOverlay(root);
+        overlay->setGeometry(QRect(unsplitTarget->mapTo(root, QPoint(0, 0)), unsplitTarget->size()));
+        overlay->setDirection(direction == MoveLeft ? Qt::LeftArrow : Qt::UpArrow);
+        overlay->raise();
+        overlay->show();
+    }
+
+    void moveUnsplit(const QPoint &globalPos)
+    {
+        if(!unsplitTarget)
+            return;
+
+        const QPoint pos = unsplitTarget->mapFromGlobal(globalPos);
+        overlay->setVisible(unsplitTarget->rect().contains(pos));
+    }
+
+    void ensureIndex()
+    {
+        index.refresh(root);
+    }
+
+    void setHover(Splittable *pane, SplitController::Corner corner)
+    {
+        if(pane == hoverPane && corner == hoverCorner)
+            return;
+
+        // only corner transitions reach the platform cursor
+        const bool wasCorner = hoverPane && hoverCorner != SplitController::NoCorner;
+        const bool isCorner = pane && corner != SplitController::NoCorner;
+        if(wasCorner && (!isCorner || pane != hoverPane))
+            hoverPane->unsetCursor();
+        if(isCorner && (!wasCorner || pane != hoverPane))
+            pane->setCursor(Qt::CrossCursor);
+
+        hoverPane = pane;
+        hoverCorner = corner;
+    }
+
+    void hover(const QPoint &globalPos)
+    {
+        const QPoint pos = root->mapFromGlobal(globalPos);
+        if(!root->rect().contains(pos))
+            return setHover(nullptr, SplitController::NoCorner);
+
+        // moves inside the hovered pane only run the corner zone test
+        Splittable *pane = hoverPane;
+        QRect rect = hoverRect;
+        if(!pane || !rect.contains(pos))
+        {
+            ensureIndex();
+            pane = index.paneAt(pos, &rect);
+            hoverRect = pane ? rect : QRect();
+        }
+        setHover(pane, pane ? SplitController::cornerAt(rect, pos) : SplitController::NoCorner);
+    }
+
+    /*
+     * Split the gesture pane once the mouse left the press position, the
+     * direction decides which side the new pane goes to. The handle between
+     * the two panes takes over the mouse so the same drag sizes the new pane.
+     */
+    bool moveGesture(const QPoint &globalPos)
+    {
+        if(unsplitTarget)
+        {
+            moveUnsplit(globalPos);
+            return true;
+        }
+
+        const int direction = mouseMoveDirection(gestureOrigin, globalPos);
+        if(direction == NoMove || !gesturePane)
+            return false;
+
+        // only moving into the pane splits it, away from the corner
+        const bool left = gestureCorner == SplitController::TopLeftCorner
+                || gestureCorner == SplitController::BottomLeftCorner;
+        const bool top = gestureCorner == SplitController::TopLeftCorner
+                || gestureCorner == SplitController::TopRightCorner;
+        const bool inwards = (direction == MoveRight && left) || (direction == MoveLeft && !left)
+                || (direction == MoveDown && top) || (direction == MoveUp && !top);
+        if(!inwards)
+        {
+            if(gestureCorner == SplitController::TopLeftCorner)
+                holdUnsplit(gesturePane, direction);
+            return false;
+        }
+
+        // the new pane is placed on the side of the corner
+        const Qt::Orientation orientation = direction == MoveLeft || direction == MoveRight
+                ? Qt::Horizontal : Qt::Vertical;
+        const int index = direction == MoveRight || direction == MoveDown ? 0 : 1;
+
+        Splittable *pane = gesturePane->split(orientation, index);
+        endGesture();
+        if(!pane)
+            return true;
+
+        auto splitter = qobject_cast<QSplitter *>(pane->parentWidget());
+        const int position = splitter->indexOf(pane);
+        splitter->handle(index == 0 ? position + 1 : position)->grabMouse(
+                    QCursor(orientation == Qt::Horizontal ? Qt::SplitHCursor : Qt::SplitVCursor));
+        return true;
+    }
+
+    void releaseGesture()
+    {
+        // the neighbour is only joined if the overlay was still shown
+        if(gesturePane && unsplitTarget && overlay && overlay->isVisible())
+            gesturePane->unsplit();
+        endGesture();
+    }
+
+    void endGesture()
+    {
+        if(overlay)
+            overlay->hide();
+        unsplitTarget = nullptr;
+        gesturePane = nullptr;
+        gestureCorner = SplitController::NoCorner;
+        setHover(nullptr, SplitController::NoCorner);
+    }
+
+    bool mouseEvent(QWidget *widget, QMouseEvent *event)
+    {
+        if(!root || !root->isVisible() || widget->window() != root->window())
+            return false;
+
+        // a root that became part of another tree leaves tracking to that one
+        if(qobject_cast<QSplitter *>(root->parentWidget()))
+            return false;
+
+        switch (event->type())
+        {
+        case QEvent::MouseMove:
+            if(gesturePane)
+            {
+                if(event->buttons() & Qt::LeftButton)
+                {
+                    moveGesture(event->globalPos());
+                    return true;
+                }
+                endGesture();
+            }
+
+            if(event->buttons() != Qt::NoButton)
+                return false;
+
+            // the same move is offered again for every parent it propagates to
+            if(event->timestamp() == lastTimestamp && event->globalPos() == lastPos)
+                return false;
+            lastTimestamp = event->timestamp();
+            lastPos = event->globalPos();
+
+            hover(event->globalPos());
+            return false;
+
+        case QEvent::MouseButtonPress:
+            if(event->button() != Qt::LeftButton || !hoverPane || hoverCorner == SplitController::NoCorner)
+                return false;
+
+            gesturePane = hoverPane;
+            gestureCorner = hoverCorner;
+            gestureOrigin = event->globalPos();
+            return true;
+
+        case QEvent::MouseButtonRelease:
+            if(event->button() != Qt::LeftButton || !gesturePane)
+                return false;
+
+            releaseGesture();
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    SplitController *q_ptr;
+    QPointer<Splittable> root;
+    PaneIndex index;
+
+    QPointer<Splittable> hoverPane;
+    QRect hoverRect; // of hoverPane in root coordinates, cleared when any pane moves
+    SplitController::Corner hoverCorner = SplitController::NoCorner;
+    ulong lastTimestamp = 0;
+    QPoint lastPos;
+
+    QPointer<Splittable> gesturePane;
+    SplitController::Corner gestureCorner = SplitController::NoCorner;
+    QPoint gestureOrigin;
+
+    QPointer<SplitOverlay> overlay;
+    QPointer<QWidget> unsplitTarget;
+};
+
+/**
+ * @brief SplitController::SplitController
+ * @param root the top level Splittable, owns the controller
+ */
+SplitController::SplitController(Splittable *root)
+    : QObject(root)
+    , d(new SplitControllerPrivate(this))
+{
+    Q_ASSERT(root != nullptr);
+    d->root = root;
+    // every event of the application passes the filter, only while the tree is shown
+    root->installEventFilter(this);
+    if(root->isVisible())
+        qApp->installEventFilter(this);
+
+    const struct { QKeySequence key; Direction direction; } bindings[] = {
+        { QKeySequence(Qt::ALT | Qt::Key_Left), Left },
+        { QKeySequence(Qt::ALT | Qt::Key_Right), Right },
+        { QKeySequence(Qt::ALT | Qt::Key_Up), Up },
+        { QKeySequence(Qt::ALT | Qt::Key_Down), Down },
+        { QKeySequence(Qt::ALT | Qt::Key_PageDown), Next },
+        { QKeySequence(Qt::ALT | Qt::Key_PageUp), Previous },
+    };
+    for(const auto &binding : bindings)
+    {
+        auto shortcut = new QShortcut(binding.key, root);
+        shortcut->setContext(Qt::WidgetWithChildrenShortcut);
+        const Direction direction = binding.direction;
+        connect(shortcut, &QShortcut::activated, this, [this, direction] { focusNeighbour(direction); });
+    }
+}
+
+SplitController::~SplitController()
+{
+    if(qApp)
+        qApp->removeEventFilter(this);
+}
+
+Splittable *SplitController::root() const
+{
+    return d->root;
+}
+
+/**
+ * @brief SplitController::paneAt
+ * @param pos in root coordinates
+ * @param rect set to the pane rectangle in root coordinates
+ */
+Splittable *SplitController::paneAt(const QPoint &pos, QRect *rect) const
+{
+    d->ensureIndex();
+    return d->index.paneAt(pos, rect);
+}
+
+void SplitController::invalidate()
+{
+    d->index.invalidate();
+    d->hoverRect = QRect();
+}
+
+/**
+ * @brief SplitController::neighbour
+ * The pane next to \a pane in \a direction: geometrically for the four
+ * sides, in tree order with wrap around for Next and Previous.
+ */
+Splittable *SplitController::neighbour(Splittable *pane, Direction direction) const
+{
+    if(!pane || !d->root)
+        return nullptr;
+
+    switch (direction)
+    {
+    case Next:
+    case Previous:
+        return d->root->registry()->pane(d->root->registry()->nextPane(pane->paneId(), direction == Next ? 1 : -1));
+    default:
+        break;
+    }
+
+    static const Qt::Edge edges[] = { Qt::LeftEdge, Qt::RightEdge, Qt::TopEdge, Qt::BottomEdge };
+    d->ensureIndex();
+    return d->index.neighbour(pane, edges[direction]);
+}
+
+/**
+ * @brief SplitController::focusedPane
+ * @return the leaf pane containing the focus widget, if it is in this tree
+ */
+Splittable *SplitController::focusedPane() const
+{
+    for(QWidget *widget = QApplication::focusWidget(); widget && d->root; widget = widget->parentWidget())
+    {
+        auto pane = qobject_cast<Splittable *>(widget);
+        if(pane && !pane->hasSplitter())
+            return pane == d->root || d->root->isAncestorOf(pane) ? pane : nullptr;
+    }
+    return nullptr;
+}
+
+bool SplitController::focusNeighbour(Direction direction)
+{
+    Splittable *pane = focusedPane();
+    if(!pane)
+    {
+        // nothing focused yet, start at the first pane
+        const QList<int> panes = d->root ? d->root->registry()->panes() : QList<int>();
+        return !panes.isEmpty() && d->root->registry()->focusPane(panes.first());
+    }
+
+    Splittable *target = neighbour(pane, direction);
+    return target && d->root->registry()->focusPane(target->paneId());
+}
+
+/*
+ * corner zones, the left-top one measured from the corner:
+ * 0,0
+ * +-----------+ 14,0
+ * |         *
+ * |       *
+ * |     *        x + y <= 14
+ * |   *
+ * | *
+ * +  0,14
+ *
+ * other corners mirror x and/or y, so a point is tested with a few integer
+ * compares, the client area is rejected by the first two band tests.
+ */
+SplitController::Corner SplitController::cornerAt(const QRect &rect, const QPoint &pos)
+{
+    const int dxLeft = pos.x() - rect.left();
+    const int dxRight = rect.right() - pos.x();
+    const int dyTop = pos.y() - rect.top();
+    const int dyBottom = rect.bottom() - pos.y();
+
+    const bool atLeft = dxLeft < CornerExtent;
+    if(!atLeft && dxRight >= CornerExtent)
+        return NoCorner;
+    const bool atTop = dyTop < CornerExtent;
+    if(!atTop && dyBottom >= CornerExtent)
+        return NoCorner;
+
+    const int dx = atLeft ? dxLeft : dxRight;
+    if(atTop && dx + dyTop <= CornerExtent)
+        return atLeft ? TopLeftCorner : TopRightCorner;
+    if(dyBottom < CornerExtent && dx + dyBottom <= CornerExtent)
+        return atLeft ? BottomLeftCorner : BottomRightCorner;
+
+    return NoCorner;
+}
+
+bool SplitController::eventFilter(QObject *watched, QEvent *event)
+{
+    if(watched == d->root && (event->type() == QEvent::Show || event->type() == QEvent::Hide))
+    {
+        qApp->removeEventFilter(this);
+        if(event->type() == QEvent::Show)
+            qApp->installEventFilter(this);
+        // geometry changes of the hidden tree went unseen
+        d->index.invalidate();
+        d->hoverRect = QRect();
+        return QObject::eventFilter(watched, event);
+    }
+
+    switch (event->type())
+    {
+    case QEvent::MouseMove:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+        if(watched->isWidgetType() && d->root && d->root->isVisible())
+            return d->mouseEvent(static_cast<QWidget *>(watched), static_cast<QMouseEvent *>(event));
+        break;
+
+    case QEvent::Resize:
+    case QEvent::Move:
+    case QEvent::Hide:
+    case QEvent::Show:
+        // pane geometry changed, its subtree is collected again on the next query
+        if(d->index.isValid() && d->root && qobject_cast<Splittable *>(watched)
+                && (watched == d->root || d->root->isAncestorOf(static_cast<QWidget *>(watched))))
+        {
+            d->index.update(static_cast<Splittable *>(watched));
+            d->hoverRect = QRect();
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,58 @@
+#ifndef SPLITCONTROLLER_H
+#define SPLITCONTROLLER_H
+
+#include <QObject>
+#include <QRect>
+
+class Splittable;
+
+class SplitControllerPrivate;
+
+/**
+ * @brief The SplitController class
+ * Tracks split gestures for a whole Splittable tree. One application event
+ * filter follows the cursor and resolves the pane and corner under it from a
+ * PaneIndex, so the panes themselves need no hover events.
+ *
+ * The same index answers directional focus navigation, bound to Alt+arrow
+ * keys and Alt+PageUp/PageDown on the root.
+ */
+class SplitController : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE_D(d, SplitController)
+public:
+    enum Corner
+    {
+        NoCorner = 0,
+        TopLeftCorner,
+        TopRightCorner,
+        BottomLeftCorner,
+        BottomRightCorner
+    };
+
+    enum { CornerExtent = 14 };
+
+    enum Direction { Left, Right, Up, Down, Next, Previous };
+
+    explicit SplitController(Splittable *root);
+    ~SplitController() override;
+
+    Splittable *root() const;
+    Splittable *paneAt(const QPoint &pos, QRect *rect = nullptr) const;
+    void invalidate();
+
+    Splittable *neighbour(Splittable *pane, Direction direction) const;
+    Splittable *focusedPane() const;
+    bool focusNeighbour(Direction direction);
+
+    static Corner cornerAt(const QRect &rect, const QPoint &pos);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QScopedPointer<SplitControllerPrivate> d;
+};
+
+#endif // SPLITCONTROLLER_H
@@ -0,0 +1,309 @@
+#include "SplitTransaction.h"
+#include "PaneRegistry.h"
+#include "Splittable.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QLayout>
+#include <QSet>
+#include <QSplitter>
+
+/*
+ * The panes below \a pane, parents before their children.
+ */
+static void collectPanes(Splittable *pane, QVector<Splittable *> &panes)
+{
+    panes.append(pane);
+    if(QSplitter *splitter = pane->splitter())
+    {
+        for(int i = 0; i < splitter->count(); ++i)
+        {
+            if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+                collectPanes(child, panes);
+        }
+    }
+}
+
+SplitTransaction::SplitTransaction(Splittable *root)
+    : m_root(root ? root->root() : nullptr)
+{
+
+}
+
+/**
+ * @brief SplitTransaction::split
+ * @return the pending id of the pane the split will create
+ */
+int SplitTransaction::split(int pane, Qt::Orientation orientation, int index)
+{
+    Operation op = operation(Operation::Split, pane);
+    op.orientation = orientation;
+    op.index = index;
+    op.result = m_nextPending--;
+    m_operations.append(op);
+    return op.result;
+}
+
+void SplitTransaction::unsplit(int pane, bool all)
+{
+    Operation op = operation(Operation::Unsplit, pane);
+    op.all = all;
+    m_operations.append(op);
+}
+
+/**
+ * @brief SplitTransaction::move
+ * Move the widget of \a pane into a new pane before (index 0) or after
+ * (index 1) \a target, see Splittable::moveTo().
+ */
+void SplitTransaction::move(int pane, int target, Qt::Orientation orientation, int index)
+{
+    Operation op = operation(Operation::Move, pane);
+    op.target = target;
+    op.orientation = orientation;
+    op.index = index;
+    m_operations.append(op);
+}
+
+/**
+ * @brief SplitTransaction::resize
+ * Give \a pane \a extent pixels along its parent splitter, the space comes
+ * from its next neighbour (the previous one for the last pane).
+ */
+void SplitTransaction::resize(int pane, int extent)
+{
+    Operation op = operation(Operation::Resize, pane);
+    op.extent = extent;
+    m_operations.append(op);
+}
+
+/**
+ * @brief SplitTransaction::swap
+ * Exchange the widgets of two leaf panes, see Splittable::swap().
+ */
+void SplitTransaction::swap(int pane, int other)
+{
+    Operation op = operation(Operation::Swap, pane);
+    op.target = other;
+    m_operations.append(op);
+}
+
+bool SplitTransaction::isEmpty() const
+{
+    return m_operations.isEmpty();
+}
+
+int SplitTransaction::count() const
+{
+    return m_operations.count();
+}
+
+/**
+ * @brief SplitTransaction::commit
+ * Apply the queued operations in order. The panes every operation refers
+ * to are looked up once, before anything is applied: if one of them does
+ * not exist, or a pending id is used before the split creating it, nothing
+ * is applied. An operation that can only fail once earlier ones were
+ * applied, e.g. splitting a pane an earlier operation removed, is skipped
+ * and the others stay applied.
+ * @return true if every operation was applied
+ */
+bool SplitTransaction::commit()
+{
+    if(!m_root)
+    {
+        rollback();
+        return false;
+    }
+
+    /* Ids follow the widgets, so a leaf is tracked by its widget, whichever
+     * pane hosts it after the earlier operations, and a branch by the pane
+     * itself. The registry is only asked before the tree changes. */
+    struct Reference
+    {
+        QPointer<QWidget> widget;
+        QPointer<Splittable> pane;
+    };
+
+    PaneRegistry *registry = m_root->registry();
+    QHash<int, Reference> references;
+    auto reference = [&](int id) -> bool {
+        if(id < 0)
+            return references.contains(id);
+        if(references.contains(id))
+            return true;
+        Splittable *pane = registry->pane(id);
+        if(!pane)
+            return false;
+        references.insert(id, {pane->widget(), pane});
+        return true;
+    };
+    auto resolve = [&](int id) -> Splittable * {
+        const Reference ref = references.value(id);
+        Splittable *pane = nullptr;
+        if(ref.widget)
+            pane = qobject_cast<Splittable *>(ref.widget->parentWidget());
+        else if(ref.pane && ref.pane->paneId() == id)
+            pane = ref.pane;
+        // removed panes are detached at once but only deleted later
+        return pane && (pane == m_root || m_root->isAncestorOf(pane)) ? pane : nullptr;
+    };
+
+    for(const Operation &op : qAsConst(m_operations))
+    {
+        const bool target = op.type == Operation::Move || op.type == Operation::Swap;
+        if(!reference(op.pane) || (target && !reference(op.target)))
+        {
+            rollback();
+            return false;
+        }
+        if(op.type == Operation::Split)
+            references.insert(op.result, Reference());
+    }
+
+    const bool updates = m_root->updatesEnabled();
+    m_root->setUpdatesEnabled(false);
+    registry->beginUpdate();
+
+    /* The layouts of the panes are switched off while the tree changes, so a
+     * change only moves the panes of its own splitter. Every pane is laid out
+     * once, top down, when they are switched on again. */
+    QVector<Splittable *> panes;
+    collectPanes(m_root, panes);
+    QSet<QLayout *> layouts;
+    auto suspendLayout = [&](Splittable *pane) {
+        QLayout *layout = pane->layout();
+        if(layout && layout->isEnabled())
+        {
+            layout->setEnabled(false);
+            layouts.insert(layout);
+        }
+    };
+    // the new pane and, after a split in place, the one keeping the widget
+    auto suspendLevel = [&](Splittable *pane) {
+        auto splitter = qobject_cast<QSplitter *>(pane->parentWidget());
+        for(int i = 0; splitter && i < splitter->count(); ++i)
+        {
+            if(auto sibling = qobject_cast<Splittable *>(splitter->widget(i)))
+                suspendLayout(sibling);
+        }
+    };
+    for(Splittable *pane : qAsConst(panes))
+        suspendLayout(pane);
+
+    // resizes only record the extents, each splitter is resized once at the end
+    QHash<QSplitter *, QPointer<QSplitter>> splitters;
+    QHash<QSplitter *, QHash<QWidget *, int>> extents;
+    auto sizesOf = [&](QSplitter *splitter) {
+        QList<int> sizes = splitter->sizes();
+        const QHash<QWidget *, int> pending = extents.value(splitter);
+        for(auto it = pending.cbegin(); it != pending.cend(); ++it)
+        {
+            const int index = splitter->indexOf(it.key());
+            if(index >= 0)
+                sizes[index] = it.value();
+        }
+        return sizes;
+    };
+
+    bool applied = true;
+    for(const Operation &op : qAsConst(m_operations))
+    {
+        Splittable *pane = resolve(op.pane);
+        if(!pane)
+        {
+            applied = false;
+            continue;
+        }
+
+        switch (op.type)
+        {
+        case Operation::Split:
+            if(Splittable *result = pane->hasSplitter() ? nullptr : pane->split(op.orientation, op.index))
+            {
+                references.insert(op.result, {result->widget(), result});
+                suspendLevel(result);
+            }
+            else
+                applied = false;
+            break;
+
+        case Operation::Unsplit:
+            pane->unsplit(op.all);
+            break;
+
+        case Operation::Move:
+            if(Splittable *moved = pane->moveTo(resolve(op.target), op.orientation, op.index))
+                suspendLevel(moved);
+            else
+                applied = false;
+            break;
+
+        case Operation::Swap:
+            if(!pane->swap(resolve(op.target)))
+                applied = false;
+            break;
+
+        case Operation::Resize:
+        {
+            auto splitter = qobject_cast<QSplitter *>(pane->parentWidget());
+            if(!splitter || splitter->count() < 2)
+            {
+                applied = false;
+                break;
+            }
+            const QList<int> sizes = sizesOf(splitter);
+            const int index = splitter->indexOf(pane);
+            const int neighbour = index + 1 < sizes.count() ? index + 1 : index - 1;
+            const int delta = qBound(-sizes[index], op.extent - sizes[index], sizes[neighbour]);
+            splitters.insert(splitter, splitter);
+            extents[splitter].insert(pane, sizes[index] + delta);
+            extents[splitter].insert(splitter->widget(neighbour), sizes[neighbour] - delta);
+            break;
+        }
+        }
+    }
+    m_operations.clear();
+
+    for(const QPointer<QSplitter> &splitter : qAsConst(splitters))
+    {
+        if(splitter)
+            splitter->setSizes(sizesOf(splitter));
+    }
+
+    panes.clear();
+    collectPanes(m_root, panes);
+    for(Splittable *pane : qAsConst(panes))
+    {
+        QLayout *layout = pane->layout();
+        if(!layouts.contains(layout))
+            continue;
+        layout->setEnabled(true);
+        layout->setGeometry(pane->rect());
+    }
+
+    registry->endUpdate();
+    // pending layout requests are handled once for the whole batch, then one repaint
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::LayoutRequest);
+    m_root->setUpdatesEnabled(updates);
+    return applied;
+}
+
+void SplitTransaction::rollback()
+{
+    m_operations.clear();
+}
+
+SplitTransaction::Operation SplitTransaction::operation(Operation::Type type, int pane) const
+{
+    Operation op;
+    op.type = type;
+    op.pane = pane;
+    op.target = 0;
+    op.orientation = Qt::Horizontal;
+    op.index = 1;
+    op.extent = 0;
+    op.all = false;
+    op.result = 0;
+    return op;
+}
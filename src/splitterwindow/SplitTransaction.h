@@ -0,0 +1,62 @@
+#ifndef SPLITTRANSACTION_H
+#define SPLITTRANSACTION_H
+
+#include <QPointer>
+#include <QVector>
+
+class Splittable;
+
+/**
+ * @brief The SplitTransaction class
+ * Queues split, unsplit, move and resize operations on a Splittable tree
+ * and applies them in commit() with updates and the pane layouts disabled
+ * and one model reset. Queued resizes are applied once per splitter at the
+ * end, then every pane is laid out once. Nothing is touched before
+ * commit(), so a rollback only drops the queue, and so does destroying an
+ * uncommitted transaction. See commit() for what happens when an operation
+ * fails.
+ *
+ * Panes are addressed by their ids. split() returns a pending id, a
+ * negative number later operations of the same transaction may use to
+ * address the pane it will create.
+ */
+class SplitTransaction
+{
+public:
+    explicit SplitTransaction(Splittable *root);
+
+    int split(int pane, Qt::Orientation orientation, int index = 1);
+    void unsplit(int pane, bool all = false);
+    void move(int pane, int target, Qt::Orientation orientation, int index = 1);
+    void resize(int pane, int extent);
+    void swap(int pane, int other);
+
+    bool isEmpty() const;
+    int count() const;
+
+    bool commit();
+    void rollback();
+
+private:
+    struct Operation
+    {
+        enum Type { Split, Unsplit, Move, Resize, Swap };
+
+        Type type;
+        int pane;
+        int target;
+        Qt::Orientation orientation;
+        int index;
+        int extent;
+        bool all;
+        int result;
+    };
+
+    Operation operation(Operation::Type type, int pane) const;
+
+    QPointer<Splittable> m_root;
+    QVector<Operation> m_operations;
+    int m_nextPending = -1;
+};
+
+#endif // SPLITTRANSACTION_H
@@ -1,169 +1,276 @@
 #include "Splittable.h"
+#include "PaneRegistry.h"
+#include "SnapshotCover.h"
+#include "SplitController.h"
+#include "SplitTransaction.h"
 #include "Splitter.h"
 #include "Viewport.h"
 
 #include <QSplitter>
 #include <QStackedWidget>
 #include <QStackedLayout>
-#include <QVBoxLayout>
-#include <QLabel>
-#include <QMouseEvent>
-#include <QHoverEvent>
-#include <QEvent>
-#include <QRegion>
-#include <QPoint>
-#include <QPainter>
+#include <QCoreApplication>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QResizeEvent>
+#include <QPointer>
+#include <QTimer>
 #include <QDebug>
 
+static int nextPaneId()
+{
+    static int id = 0;
+    return ++id;
+}
 
-/*
- * Overlay arrow:
- * (0,0)
- * +--------------------+
- * |                    |
- * |        | \         |
- * |        |  \        |
- * |--------+   \       |
- * |            /       | 1/4, 1/5
- * |--------+  /        |
- * |        | /         |
- * |        |/          |
- * |                    |
- * +--------------------+ (width, height)
- */
-class Overlay : public QWidget
+class SplittablePrivate
 {
 public:
-    Overlay(Splittable *parent) : QWidget(parent)
+    SplittablePrivate(Splittable *q) : q_ptr(q) {}
+
+    QSplitter *parentSplitter() const
     {
-        this->resize(parent->width(), parent->height());
-        this->raise();
-        setStyleSheet("background-color: rgba(0, 0, 0, 127)");
+        return qobject_cast<QSplitter *>(q_ptr->parentWidget());
     }
 
-    void paintEvent(QPaintEvent */*event*/) override
+    /*
+     * The new side of a split shows the same content as this pane, the
+     * duplicated viewport shares its provider instead of copying it.
+     */
+    QWidget *duplicateWidget() const
     {
-        QPainter painter(this);
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(QColor("#999999"));
+        auto viewport = qobject_cast<Viewport *>(widget);
+        return viewport ? viewport->duplicate() : nullptr;
+    }
 
-        int offsetX = width() / 4;
-        int offsetY = height() / 5;
-        QPolygon basePoly;
-        basePoly << QPoint(3 * offsetX, height() / 2)
+    Splittable *owner() const
+    {
+        QSplitter *parent = parentSplitter();
+        return parent ? qobject_cast<Splittable *>(parent->parentWidget()) : nullptr;
+    }
 
-                 << QPoint(2 * offsetX, 4 * offsetY)
-                 << QPoint(2 * offsetX, 3 * offsetY)
-                 << QPoint(0, 3 * offsetY)
+    /*
+     * Replace the splitter of this level by the content of its only child,
+     * the child and the old splitter are deleted later because the child may
+     * still be inside its own event handler.
+     */
+    void collapse()
+    {
+        if(!splitter || splitter->count() != 1)
+            return;
 
-                 << QPoint(0, 2 * offsetY)
-                 << QPoint(2 * offsetX, 2 * offsetY)
-                 << QPoint(2 * offsetX, offsetY);
+        auto child = qobject_cast<Splittable *>(splitter->widget(0));
+        if(!child)
+            return;
+
+        QSplitter *origin = takeSplitter();
+        if(child->hasSplitter())
+        {
+            splitter = child->takeSplitter();
+            layout->addWidget(splitter);
+            layout->setCurrentWidget(splitter);
+        }
+        else
+        {
+            // the pane showing the widget keeps its id
+            id = child->d->id;
+            adopt(child->tabkeWidget());
+        }
 
-        // TODO: translate direction with QMitrix
+        origin->hide();
+        origin->deleteLater();
+    }
 
-        painter.drawPolygon(basePoly);
+    /*
+     * Show a widget taken from another pane. It is reparented, never
+     * recreated, and told about this pane's visibility, it may have been
+     * suspended where it came from.
+     */
+    void adopt(QWidget *content)
+    {
+        widget = content;
+        if(auto viewport = qobject_cast<Viewport *>(widget))
+            viewport->setSplitter(q_ptr);
+        layout->addWidget(widget);
+        layout->setCurrentWidget(widget);
+        notifyContent();
     }
 
-//private:
-//    int direction = 0;
-};
+    /*
+     * Move the panes of this level into the parent splitter when both split
+     * in the same direction, so a chain of same-orientation splits becomes
+     * one n-ary splitter. The extent of this level is distributed over its
+     * children in proportion to their current sizes.
+     */
+    bool mergeIntoParent()
+    {
+        QSplitter *parent = parentSplitter();
+        if(!splitter || !parent || parent->orientation() != splitter->orientation())
+            return false;
 
-/*
- * default left-bottom corner mask:
- * 0,0
- * +---+  2, 0
- * |     *
- * |	   *
- * |	     *
- * |           *  12,10
- * | 		     |
- * +-------------+
- * 0,12           12,12
- *
- * other corner mask: ratate 90, 180, -90 with a QMatrix
- */
+        const int index = parent->indexOf(q_ptr);
+        QList<int> parentSizes = parent->sizes();
+        const int extent = parentSizes.takeAt(index);
 
-class SplittablePrivate
-{
-public:
-    enum HintRegion
+        const QList<int> sizes = splitter->sizes();
+        int total = 0;
+        for(int size : sizes)
+            total += size;
+
+        int error = 0;
+        for(int i = 0; i < sizes.count(); ++i)
+        {
+            const int scaled = total > 0 ? sizes[i] * extent + error : extent + error;
+            const int size = total > 0 ? scaled / total : scaled / sizes.count();
+            error = scaled - size * (total > 0 ? total : sizes.count());
+
+            parent->insertWidget(index + i, splitter->widget(0));
+            parentSizes.insert(index + i, size);
+        }
+        parent->setSizes(parentSizes);
+
+        QSplitter *origin = takeSplitter();
+        origin->deleteLater();
+        q_ptr->hide();
+        q_ptr->deleteLater();
+        return true;
+    }
+
+    /*
+     * While the window is resized the content keeps its geometry behind a
+     * snapshot, and is laid out once when no resize came for a while.
+     */
+    void freeze()
     {
-        HintClient = 0,
-        HintLeftTop,
-        HintRightTop,
-        HintLeftBottom,
-        HintRightBottom
-    };
+        if(!frozen)
+        {
+            QWidget *content = layout->currentWidget();
+            if(!content)
+                return;
 
-    enum MoveDirection
+            if(!cover)
+                cover = new SnapshotCover(q_ptr);
+            if(!thaw)
+            {
+                thaw = new QTimer(q_ptr);
+                thaw->setSingleShot(true);
+                thaw->setInterval(150);
+                QObject::connect(thaw, &QTimer::timeout, q_ptr, [this] { unfreeze(); });
+            }
+
+            const QPixmap pixmap = content->grab();
+            layout->setEnabled(false);
+            cover->clear();
+            cover->addSnapshot(pixmap, q_ptr->rect());
+            cover->raise();
+            cover->show();
+            frozen = true;
+        }
+
+        cover->setGeometry(q_ptr->rect());
+        cover->setSnapshotRect(0, q_ptr->rect());
+        thaw->start();
+    }
+
+    void unfreeze()
     {
-        MoveLeft = 0,// West
-        MoveRight,  // East
-        MoveUp,     // North
-        MoveDown    // South
-    };
+        if(!frozen)
+            return;
+
+        frozen = false;
+        layout->setEnabled(true);
+        layout->setGeometry(q_ptr->rect());
+        cover->hide();
+        cover->clear();
+    }
 
-    SplittablePrivate(Splittable *q) : q_ptr(q)
+    /*
+     * Collapse this level if only one pane is left, then let it merge into a
+     * parent of the same orientation.
+     */
+    void simplify()
     {
-        leftTopMask << QPoint(-2, -2)
-                    << QPoint(14, -2)
-                    << QPoint(12, 2)
-                    << QPoint(2, 12)
-                    << QPoint(-2, 14);
+        if(splitter && splitter->count() == 1)
+        {
+            collapse();
+            mergeIntoParent();
+        }
+        structureChanged();
     }
 
-    void reposition()
+    void structureChanged()
     {
-        leftBottomMask = QMatrix().rotate(-90).map(leftTopMask);
-        rightTopMask = QMatrix().rotate(90).map(leftTopMask);
-        rightBottomMask = QMatrix().rotate(180).map(leftTopMask);
-
-        int offsetX = q_ptr->width();
-        int offsetY = q_ptr->height();
-        leftBottomMask.translate(0, offsetY);
-        rightTopMask.translate(offsetX, 0);
-        rightBottomMask.translate(offsetX, offsetY);
+        Splittable *root = q_ptr->root();
+        if(root->d->registry)
+            root->d->registry->invalidate();
+        /* A pane split in place keeps its geometry and removed panes are no
+         * longer below the root, neither reaches the incremental update. */
+        if(root->d->controller)
+            root->d->controller->invalidate();
     }
 
-    int mouseMoveDirection(const QPoint start, const QPoint &end)
+    Splittable::Visibility computeVisibility() const
     {
-        enum DirectionMask
-        {
-            Left    = 0x0001,
-            Top     = 0x0010,
-            Right   = 0x0100,
-            Bottom  = 0x1000,
-        };
-
-        const auto direction =
-                Left    * (end.x() < start.x()) |
-                Right   * (end.x() > start.x()) |
-                Top     * (end.y() < start.y()) |
-                Bottom  * (end.y() > start.y());
-
-        QPoint point = end - start;
-        const int deltaX = qAbs(point.x());
-        const int deltaY = qAbs(point.y());
-
-        switch (direction)
+        if(!q_ptr->isVisible())
+            return Splittable::Hidden;
+        if(occluded || q_ptr->window()->isMinimized())
+            return Splittable::Occluded;
+        if(q_ptr->width() < Splittable::CollapsedExtent || q_ptr->height() < Splittable::CollapsedExtent)
+            return Splittable::Collapsed;
+        return Splittable::Visible;
+    }
+
+    /*
+     * Only transitions are reported. The hosted widget is compared with its
+     * own state instead: it starts running, whatever state the pane is first
+     * found in, so a pane first shown collapsed still suspends it.
+     */
+    void updateVisibility()
+    {
+        const Splittable::Visibility state = computeVisibility();
+        const bool wasSuspended = visibility != Splittable::Visible;
+        if(state != visibility)
         {
-        case Left:          return MoveLeft;
-        case Top:           return MoveUp;
-        case Right:         return MoveRight;
-        case Bottom:        return MoveDown;
-        case Left | Top:    return deltaX >= deltaY ? MoveLeft  : MoveUp;   // default left if 45 degree
-        case Left | Bottom: return deltaX >= deltaY ? MoveLeft  : MoveDown;
-        case Right | Top:   return deltaX >= deltaY ? MoveRight : MoveUp;   // default right if 45 degree
-        case Right | Bottom:return deltaX >= deltaY ? MoveRight : MoveDown;
+            visibility = state;
+            emit q_ptr->visibilityChanged(state);
         }
 
-        return 0;
+        const bool suspended = state != Splittable::Visible;
+        if(widget && suspended != contentSuspended())
+            notifyContent();
+        if(suspended == wasSuspended)
+            return;
+
+        if(suspended)
+            emit q_ptr->suspended();
+        else
+            emit q_ptr->resumed();
+    }
+
+    // a viewport knows its state, other widgets only what they were told
+    bool contentSuspended() const
+    {
+        auto viewport = qobject_cast<Viewport *>(widget);
+        return viewport ? viewport->isSuspended() : suspendSent;
+    }
+
+    void notifyContent()
+    {
+        if(!widget)
+            return;
+
+        suspendSent = visibility != Splittable::Visible;
+        QEvent event(suspendSent ? Splittable::SuspendEvent : Splittable::ResumeEvent);
+        QCoreApplication::sendEvent(widget, &event);
     }
 
-    void holdUnsplit(Splittable *splitter)
+    QSplitter *takeSplitter()
     {
-        // TODO: show this widget if splitter can be unsplited.
+        QSplitter *origin = splitter;
+        if(splitter)
+            layout->removeWidget(splitter);
+        splitter = nullptr;
+        return origin;
     }
 
     Splittable *q_ptr;
@@ -171,19 +278,23 @@ public:
     QStackedWidget *container = nullptr;
     QStackedLayout *layout = nullptr;
     QWidget *widget = nullptr;
-    QWidget *overlay = nullptr;
-
-    QPolygon leftTopMask; // as a base polygon
-    QPolygon leftBottomMask;
-    QPolygon rightTopMask;
-    QPolygon rightBottomMask;
-
-    HintRegion hintRegion = HintClient;
-    QPoint directionOriginPos;
-    bool splitting = false;
-    bool inCorner = false;
+    SplitController *controller = nullptr;
+    PaneRegistry *registry = nullptr;
+    int id = 0;
+
+    QPointer<SnapshotCover> cover;
+    QTimer *thaw = nullptr;
+    bool snapshotResize = false;
+    bool frozen = false;
+
+    Splittable::Visibility visibility = Splittable::Hidden;
+    bool occluded = false;
+    bool suspendSent = false;
 };
 
+const QEvent::Type Splittable::SuspendEvent = QEvent::Type(QEvent::registerEventType());
+const QEvent::Type Splittable::ResumeEvent = QEvent::Type(QEvent::registerEventType());
+
 /**
  * @brief Splittable::Splittable
  * @param widget
@@ -191,29 +302,59 @@ public:
 Splittable::Splittable(QWidget *widget)
     : d(new SplittablePrivate(this))
 {
+    d->id = nextPaneId();
+
     setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
-    setAttribute(Qt::WA_Hover);
 
     d->layout = new QStackedLayout(this);
     d->layout->setSizeConstraint(QLayout::SetNoConstraint);
 
     d->widget = widget ? widget : new Viewport(this);
+    if(auto viewport = qobject_cast<Viewport *>(d->widget))
+        viewport->setSplitter(this);
     d->layout->addWidget(d->widget);
 }
 
-void Splittable::split(Qt::Orientation orientation)
+Splittable *Splittable::split(Qt::Orientation orientation)
 {
-    Q_UNUSED(orientation)
+    return split(orientation, 1);
 }
 
-void Splittable::split(Qt::Orientation orientation, int index)
+/**
+ * @brief Splittable::split
+ * Split this pane and place a new pane before (index 0) or after (index 1)
+ * it. The new pane starts at its minimum size and shows \a widget, or a
+ * duplicate of this pane's viewport if \a widget is null.
+ * @return the new pane
+ */
+Splittable *Splittable::split(Qt::Orientation orientation, int index, QWidget *widget)
 {
-    if(d->splitting)
-        return;
-    d->splitting = true;
-
     Q_ASSERT(d->splitter == nullptr);
+    if(d->splitter)
+        return nullptr;
+
+    QWidget *newWidget = widget ? widget : d->duplicateWidget();
+
+    // same direction as the parent: add a sibling instead of nesting a level
+    QSplitter *parent = d->parentSplitter();
+    if(parent && parent->orientation() == orientation)
+    {
+        const int position = parent->indexOf(this) + (index == 0 ? 0 : 1);
+        QList<int> sizes = parent->sizes();
+        auto pane = new Splittable(newWidget);
+        parent->insertWidget(position, pane);
+
+        const int self = parent->indexOf(this);
+        sizes.insert(position, 2);
+        sizes[self] = qMax(0, sizes[self] - 2);
+        parent->setSizes(sizes);
+        d->structureChanged();
+        return pane;
+    }
+
     d->splitter = new Splitter(orientation, this);
+    // sized like the layout would, it is disabled while a transaction commits
+    d->splitter->setGeometry(rect());
     d->layout->addWidget(d->splitter);
     d->layout->removeWidget(d->widget);
     QWidget *originWidget = d->widget;
@@ -223,8 +364,11 @@ void Splittable::split(Qt::Orientation orientation, int index)
     index = index >= 2 ? 1 : index;
     Splittable *duplicate = nullptr;
     Splittable *origin = nullptr;
-    d->splitter->insertWidget(index, duplicate = new Splittable());
+    d->splitter->insertWidget(index, duplicate = new Splittable(newWidget));
     d->splitter->insertWidget(!index, origin = new Splittable(originWidget));
+    // the id follows the widget, this pane is a new branch
+    origin->d->id = d->id;
+    d->id = nextPaneId();
 
     // set mini size for the newly
     QList<int> sizes = d->splitter->sizes();
@@ -232,56 +376,155 @@ void Splittable::split(Qt::Orientation orientation, int index)
     d->splitter->setSizes(sizes);
 
     d->layout->setCurrentWidget(d->splitter);
-
-    d->splitter->handle(1)->grabMouse(QCursor(orientation == Qt::Horizontal
-                                              ? Qt::SplitHCursor : Qt::SplitVCursor));
+    d->structureChanged();
+    return duplicate;
 }
 
+/**
+ * @brief Splittable::unsplit
+ * Let this pane take the space of its previous neighbour (the next one for
+ * the first pane), or of all its siblings if \a all is true. A level left
+ * with a single pane is collapsed into its owner.
+ */
 void Splittable::unsplit(bool all)
 {
-    Q_UNUSED(all)
-    auto parentSplitter = qobject_cast<QSplitter *>(parentWidget());
-    if(!parentSplitter)
+    QSplitter *parentSplitter = d->parentSplitter();
+    if(!parentSplitter || parentSplitter->count() < 2)
         return;
 
-    // TODO: IMPL
+    // may be called from inside an event handler of a sibling, like remove()
+    auto discard = [](QWidget *widget) {
+        widget->hide();
+        widget->setParent(nullptr);
+        widget->deleteLater();
+    };
 
     QList<int> sizes = parentSplitter->sizes();
     int index = parentSplitter->indexOf(this);
-    qDebug() << Q_FUNC_INFO << index << parentSplitter->count();
-    if(index > 0 && index < parentSplitter->count())
+    if(all)
     {
-        sizes[index] += sizes[index - 1];
-        sizes.removeAt(index - 1);
-        delete parentSplitter->widget(index - 1);
+        for(int i = parentSplitter->count() - 1; i >= 0; --i)
+        {
+            if(i != index)
+                discard(parentSplitter->widget(i));
+        }
     }
+    else
+    {
+        const int neighbour = index > 0 ? index - 1 : index + 1;
+        sizes[index] += sizes[neighbour];
+        sizes.removeAt(neighbour);
+        discard(parentSplitter->widget(neighbour));
+        parentSplitter->setSizes(sizes);
+    }
+
+    Splittable *owner = d->owner();
+    if(!owner)
+    {
+        d->structureChanged();
+        return;
+    }
+    owner->d->simplify();
+}
 
-/*
-    QWidget *widget = this->tabkeWidget();
+/**
+ * @brief Splittable::remove
+ * Remove this pane from the tree, its previous neighbour (the next one for
+ * the first pane) takes its space. The root pane can not be removed.
+ * @return true if the pane was removed, it is deleted later
+ */
+bool Splittable::remove()
+{
+    QSplitter *parentSplitter = d->parentSplitter();
+    if(!parentSplitter || parentSplitter->count() < 2)
+        return false;
 
+    Splittable *owner = d->owner();
+    QList<int> sizes = parentSplitter->sizes();
+    const int index = parentSplitter->indexOf(this);
+    const int neighbour = index > 0 ? index - 1 : index + 1;
+    sizes[neighbour] += sizes[index];
+    sizes.removeAt(index);
+
+    // may be called from inside one of this pane's own event handlers
+    hide();
+    setParent(nullptr);
+    deleteLater();
+    parentSplitter->setSizes(sizes);
+
+    if(owner)
+        owner->d->simplify();
+    return true;
+}
+
+/**
+ * @brief Splittable::moveTo
+ * Move the widget of this pane into a new pane before (index 0) or after
+ * (index 1) \a target, splitting the target's extent in half. The widget is
+ * reparented, not recreated, and keeps its pane id. This pane is removed.
+ * @return the pane now showing the widget
+ */
+Splittable *Splittable::moveTo(Splittable *target, Qt::Orientation orientation, int index)
+{
+    if(!target || target == this || d->splitter || target->d->splitter || !d->parentSplitter())
+        return nullptr;
+
+    // insert first, removing this pane may collapse the target's level
+    Splittable *moved = target->split(orientation, index, tabkeWidget());
+    moved->d->id = d->id;
+    d->id = nextPaneId();
+
+    QSplitter *splitter = moved->d->parentSplitter();
+    QList<int> sizes = splitter->sizes();
+    const int self = splitter->indexOf(moved);
+    const int other = index == 0 ? self + 1 : self - 1;
+    const int total = sizes[self] + sizes[other];
+    sizes[self] = total / 2;
+    sizes[other] = total - sizes[self];
+    splitter->setSizes(sizes);
+
+    remove();
+    return moved;
+}
+
+/**
+ * @brief Splittable::swap
+ * Exchange the widgets of two leaf panes, the ids go with the widgets.
+ */
+bool Splittable::swap(Splittable *other)
+{
+    if(!other || other == this || d->splitter || other->d->splitter)
+        return false;
+
+    QWidget *mine = tabkeWidget();
+    QWidget *theirs = other->tabkeWidget();
+    d->adopt(theirs);
+    other->d->adopt(mine);
+    qSwap(d->id, other->d->id);
+    d->structureChanged();
+    return true;
+}
+
+/**
+ * @brief Splittable::normalize
+ * Collapse single-pane levels and merge consecutive same-orientation levels
+ * of the tree below this pane into n-ary splitters.
+ */
+void Splittable::normalize()
+{
     if(!d->splitter)
         return;
 
-    Q_ASSERT(d->splitter->count() == 1);
-
-    auto childSplittable = qobject_cast<Splittable *>(d->splitter->widget(0));
-    QSplitter *origin = d->splitter;
-    d->splitter = nullptr;
-    if(childSplittable->hasSplitter())
+    // backwards, a merged child is replaced by its panes at the same index
+    for(int i = d->splitter->count() - 1; i >= 0; --i)
     {
-        d->splitter = childSplittable->takeSplitter();
-        d->layout->addWidget(d->splitter);
-        d->layout->setCurrentWidget(d->splitter);
-    }
-    else
-    {
-        d->widget = childSplittable->widget();
-        d->layout->addWidget(d->widget);
-        d->layout->setCurrentWidget(d->widget);
+        if(auto child = qobject_cast<Splittable *>(d->splitter->widget(i)))
+            child->normalize();
     }
 
-    delete origin;
-*/
+    d->collapse();
+    d->mergeIntoParent();
+    d->structureChanged();
 }
 
 QWidget *Splittable::widget() const
@@ -308,188 +551,120 @@ bool Splittable::hasSplitter() const
 
 QSplitter *Splittable::takeSplitter()
 {
-    QSplitter *origin = d->splitter;
-    if(d->splitter)
-    {
-        d->layout->removeWidget(d->splitter);
-    }
+    return d->takeSplitter();
+}
 
-    d->splitter = nullptr;
-    return origin;
+QSplitter *Splittable::splitter() const
+{
+    return d->splitter;
 }
 
-void Splittable::mousePressEvent(QMouseEvent *event)
+/**
+ * @brief Splittable::paneId
+ * @return an id unique to this pane for the lifetime of the application. The
+ * id follows the widget: when a pane is split, the pane that keeps showing
+ * its widget keeps the id, and a pane that adopts the widget of a collapsed
+ * child takes over the child's id.
+ */
+int Splittable::paneId() const
 {
-    qDebug() << Q_FUNC_INFO << event->button() <<  d->directionOriginPos;
-    if(event->button() == Qt::LeftButton)
-    {
-        d->splitting = false;
-        if(d->inCorner)
-        {
-//            qDebug() << Q_FUNC_INFO << event->button() <<  d->directionOriginPos;
-            d->directionOriginPos = event->globalPos();
-            event->accept();
-        }
-    }
-    else
-    {
-        releaseMouse();
-        event->ignore();
-    }
+    return d->id;
 }
 
-void Splittable::mouseReleaseEvent(QMouseEvent *event)
+Splittable *Splittable::root() const
 {
-    if(event->button() == Qt::LeftButton)
-    {
-        qDebug() << Q_FUNC_INFO << event->button() << d->overlay;
-        if(d->overlay)
-        {
-            delete d->overlay;
-            d->overlay = nullptr;
-        }
-    }
+    const Splittable *root = this;
+    while(Splittable *owner = root->d->owner())
+        root = owner;
+    return const_cast<Splittable *>(root);
 }
 
-void Splittable::mouseMoveEvent(QMouseEvent *event)
+/**
+ * @brief Splittable::controller
+ * @return the split gesture controller of the root of this tree
+ */
+SplitController *Splittable::controller() const
 {
-    if(event->buttons() & Qt::LeftButton)
-    {
-//        qDebug() << Q_FUNC_INFO << event->buttons();
-        const QPoint pos = event->globalPos();
-        switch (d->hintRegion)
-        {
-        case SplittablePrivate::HintClient:
-            break;
-        case SplittablePrivate::HintLeftTop:
-        {
-            int direction = d->mouseMoveDirection(d->directionOriginPos, pos);
-            switch (direction)
-            {
-            case SplittablePrivate::MoveLeft:
-                // create a overlay widget for unsplit
-                d->holdUnsplit(this);
-                break;
-            case SplittablePrivate::MoveRight:
-                this->split(Qt::Horizontal, 0);
-                break;
-            case SplittablePrivate::MoveUp:
-                // create a overlay widget for unsplit
-                d->holdUnsplit(this);
-                break;
-            case SplittablePrivate::MoveDown:
-                this->split(Qt::Vertical, 0);
-                break;
-            }
-            break;
-        }
-        case SplittablePrivate::HintRightTop:
-        {
-            int direction = d->mouseMoveDirection(d->directionOriginPos, pos);
-            if(direction == SplittablePrivate::MoveLeft)
-                this->split(Qt::Horizontal, 1);
-            else if (direction == SplittablePrivate::MoveDown)
-                this->split(Qt::Vertical, 0);
+    return root()->d->controller;
+}
 
-            break;
-        }
-        case SplittablePrivate::HintLeftBottom:
-        {
-            int direction = d->mouseMoveDirection(d->directionOriginPos, pos);
-            if(direction == SplittablePrivate::MoveRight)
-                this->split(Qt::Horizontal, 0);
-            else if (direction == SplittablePrivate::MoveUp)
-                this->split(Qt::Vertical, 1);
-            break;
-        }
-        case SplittablePrivate::HintRightBottom:
-        {
-            int direction = d->mouseMoveDirection(d->directionOriginPos, pos);
-            if(direction == SplittablePrivate::MoveLeft)
-                this->split(Qt::Horizontal, 1);
-            else if (direction == SplittablePrivate::MoveUp)
-                this->split(Qt::Vertical, 1);
-            break;
-        }
-        }
-    }
+/**
+ * @brief Splittable::registry
+ * @return the pane registry of the root of this tree, created on first use
+ */
+PaneRegistry *Splittable::registry() const
+{
+    Splittable *root = this->root();
+    if(!root->d->registry)
+        root->d->registry = new PaneRegistry(root);
+    return root->d->registry;
+}
 
-    QWidget::mouseMoveEvent(event);
+/**
+ * @brief Splittable::transaction
+ * @return an empty transaction on the root of this tree
+ */
+SplitTransaction Splittable::transaction()
+{
+    return SplitTransaction(root());
 }
 
-void Splittable::resizeEvent(QResizeEvent *)
+/**
+ * @brief Splittable::setSnapshotResize
+ * Paint a frozen snapshot of the tree while the root is being resized and
+ * lay out the real content once the resize stopped. Only used on the root.
+ */
+void Splittable::setSnapshotResize(bool enabled)
 {
-    d->reposition();
+    d->snapshotResize = enabled;
+    if(!enabled)
+        d->unfreeze();
 }
 
-bool Splittable::event(QEvent *event)
+bool Splittable::snapshotResize() const
 {
-    switch (event->type())
-    {
-    case QEvent::HoverEnter:
-        this->hoverEnter(static_cast<QHoverEvent *>(event));
-        break;
-    case QEvent::HoverMove:
-        this->hoverMove(static_cast<QHoverEvent *>(event));
-        break;
-    case QEvent::HoverLeave:
-        this->hoverLeave(static_cast<QHoverEvent *>(event));
-        break;
-
-    default: break;
-    }
+    return d->snapshotResize;
+}
 
-    return QWidget::event(event);
+/**
+ * @brief Splittable::visibility
+ * @return the effective visibility of the pane, updated on show, hide and
+ * resize
+ */
+Splittable::Visibility Splittable::visibility() const
+{
+    return d->visibility;
 }
 
-void Splittable::hoverEnter(QHoverEvent *event)
+bool Splittable::isSuspended() const
 {
-//    qDebug() << Q_FUNC_INFO << event->type();
+    return d->visibility != Visible;
 }
 
-void Splittable::hoverMove(QHoverEvent *event)
+void Splittable::showEvent(QShowEvent *event)
 {
-    const QPoint cursor = event->pos();
+    // only the root of a tree tracks split gestures
+    if(!d->controller && !d->parentSplitter())
+        d->controller = new SplitController(this);
 
-    if(d->leftTopMask.containsPoint(cursor, Qt::OddEvenFill))
-    {
-//        qDebug() << Q_FUNC_INFO << event->type() << cursor;
-        d->inCorner = true;
-//        this->setMask(d->leftTopMask);
-        d->hintRegion = SplittablePrivate::HintLeftTop;
-        this->setCursor(Qt::CrossCursor);
-    }
-    else if(d->leftBottomMask.containsPoint(cursor, Qt::OddEvenFill))
-    {
-        d->inCorner = true;
-//        this->setMask(d->leftBottomMask);
-        d->hintRegion = SplittablePrivate::HintLeftBottom;
-        this->setCursor(Qt::CrossCursor);
-    }
-    else if(d->rightTopMask.containsPoint(cursor, Qt::OddEvenFill))
-    {
-        d->inCorner = true;
-//        this->setMask(d->rightTopMask);
-        d->hintRegion = SplittablePrivate::HintRightTop;
-        this->setCursor(Qt::CrossCursor);
-    }
-    else if(d->rightBottomMask.containsPoint(cursor, Qt::OddEvenFill))
-    {
-        d->inCorner = true;
-//        this->setMask(d->rightBottomMask);
-        d->hintRegion = SplittablePrivate::HintRightBottom;
-        this->setCursor(Qt::CrossCursor);
-    }
-    else
-    {
-        d->inCorner = false;
-        d->hintRegion = SplittablePrivate::HintClient;
-        this->setCursor(Qt::ArrowCursor);
-    }
+    d->occluded = false;
+    d->updateVisibility();
+    QWidget::showEvent(event);
 }
 
-void Splittable::hoverLeave(QHoverEvent *event)
+void Splittable::hideEvent(QHideEvent *event)
 {
-//    qDebug() << Q_FUNC_INFO << event->type();
-//    this->clearMask();
+    // a spontaneous hide comes from the window system, the pane is still shown
+    d->occluded = event->spontaneous();
+    d->updateVisibility();
+    QWidget::hideEvent(event);
+}
+
+void Splittable::resizeEvent(QResizeEvent *event)
+{
+    if(d->snapshotResize && isVisible() && !d->parentSplitter())
+        d->freeze();
+
+    d->updateVisibility();
+    QWidget::resizeEvent(event);
 }
@@ -2,8 +2,12 @@
 #define SPLITTABLE_H
 
 #include <QWidget>
+#include <QEvent>
 
 class QSplitter;
+class PaneRegistry;
+class SplitController;
+class SplitTransaction;
 
 class SplittablePrivate;
 class Splittable : public QWidget
@@ -11,32 +15,60 @@ class Splittable : public QWidget
     Q_OBJECT
     Q_DECLARE_PRIVATE_D(d, Splittable)
 public:
+    /**
+     * How much of the pane a user can see: hidden panes are not shown at
+     * all, collapsed panes are squeezed below CollapsedExtent, occluded panes
+     * are shown but unmapped by the window system, e.g. minimized.
+     */
+    enum Visibility { Hidden, Collapsed, Occluded, Visible };
+    Q_ENUM(Visibility)
+
+    static const int CollapsedExtent = 16;
+
+    // sent to the hosted widget when the pane stops or starts being visible
+    static const QEvent::Type SuspendEvent;
+    static const QEvent::Type ResumeEvent;
+
     explicit Splittable(QWidget *widget = nullptr);
 
-    void split(Qt::Orientation orientation);
-    void split(Qt::Orientation orientation, int index);
+    Splittable *split(Qt::Orientation orientation);
+    Splittable *split(Qt::Orientation orientation, int index, QWidget *widget = nullptr);
     void unsplit(bool all = false);
+    bool remove();
+    Splittable *moveTo(Splittable *target, Qt::Orientation orientation, int index);
+    bool swap(Splittable *other);
+    void normalize();
 
     QWidget *widget() const;
     QWidget *tabkeWidget();
 
     bool hasSplitter() const;
+    QSplitter *splitter() const;
     QSplitter *takeSplitter();
 
+    int paneId() const;
+    Splittable *root() const;
+    SplitController *controller() const;
+    PaneRegistry *registry() const;
+    SplitTransaction transaction();
+
+    void setSnapshotResize(bool enabled);
+    bool snapshotResize() const;
+
+    Visibility visibility() const;
+    bool isSuspended() const;
+
 signals:
+    void visibilityChanged(Splittable::Visibility visibility);
+    void suspended();
+    void resumed();
 
 public slots:
 
 protected:
-    void mousePressEvent(QMouseEvent *event) override;
-    void mouseReleaseEvent(QMouseEvent *event) override;
-    void mouseMoveEvent(QMouseEvent *event) override;
-    void resizeEvent(QResizeEvent *) override;
-    bool event(QEvent *event) override;
-
-    virtual void hoverEnter(QHoverEvent *event);
-    virtual void hoverMove(QHoverEvent *event);
-    virtual void hoverLeave(QHoverEvent *event);
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private:
     QScopedPointer<SplittablePrivate> d;
@@ -1,8 +1,15 @@
 #include "Splitter.h"
+#include "SnapshotCover.h"
+#include "Splittable.h"
 
 #include <QApplication>
 #include <QPainter>
 #include <QPaintEvent>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QScreen>
+#include <QTimer>
+#include <QVarLengthArray>
 
 #include <QDebug>
 
@@ -14,39 +21,373 @@ class SplitterHandle : public QSplitterHandle
 public:
     explicit SplitterHandle(Qt::Orientation orientation, QSplitter *parent = nullptr);
 
+    // invisible grab zone on each side of the painted line
+    static const int HandleMargin = 3;
+
 protected:
+    bool event(QEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
+
+private:
+    Splitter *splitter() const;
+    void updateMargins();
+    int frameInterval() const;
+    QPixmap grabPane(QWidget *widget, qint64 *cost) const;
+    qint64 grabNeighbours();
+    qint64 paintCost(bool *measured);
+    void rememberCost(qint64 cost);
+    void beginDrag();
+    void endDrag();
+    bool showSnapshots();
+    void moveSnapshots(int position);
+    void applyPendingPosition();
+
+    QTimer m_throttle;
+    Splitter::ResizeMode m_mode = Splitter::OpaqueResize;
+    bool m_dragging = false;
+    int m_offset = 0;
+    int m_pendingPos = -1;
+
+    // paint cost of the two neighbours, measured again after their content changed
+    QPointer<QWidget> m_costPanes[2];
+    qint64 m_cost = -1;
+
+    QPixmap m_snapshots[2];
+    QPointer<SnapshotCover> m_cover;
+    QRect m_coverArea; // in splitter coordinates
 };
 
 SplitterHandle::SplitterHandle(Qt::Orientation orientation, QSplitter *parent)
     : QSplitterHandle(orientation, parent)
 {
-    setMask(QRegion(contentsRect()));
-    setAttribute(Qt::WA_MouseNoMask, true);
+    updateMargins();
+
+    m_throttle.setSingleShot(true);
+    m_throttle.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&m_throttle, &QTimer::timeout, this, [this] { applyPendingPosition(); });
+}
+
+Splitter *SplitterHandle::splitter() const
+{
+    return static_cast<Splitter *>(QSplitterHandle::splitter());
+}
+
+/**
+ * @brief SplitterHandle::updateMargins
+ * QSplitter grows the handle geometry by its contents margins and keeps the
+ * handles raised above the panes, so the margins are a wider hit zone over
+ * the neighbours while only the contents rect is painted. No mask needed.
+ */
+void SplitterHandle::updateMargins()
+{
+    orientation() == Qt::Horizontal ? setContentsMargins(HandleMargin, 0, HandleMargin, 0)
+                                    : setContentsMargins(0, HandleMargin, 0, HandleMargin);
+}
+
+int SplitterHandle::frameInterval() const
+{
+    const QScreen *screen = this->screen();
+    const qreal rate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60.0;
+    return qMax(1, qRound(1000.0 / rate));
+}
+
+/**
+ * @brief SplitterHandle::grabPane
+ * Grab the pane into a pixmap, \a cost is increased by the time it took in
+ * microseconds, which is about the cost of one repaint.
+ */
+QPixmap SplitterHandle::grabPane(QWidget *widget, qint64 *cost) const
+{
+    if(!widget || !widget->isVisible() || widget->size().isEmpty())
+        return QPixmap();
+
+    QElapsedTimer timer;
+    timer.start();
+    const QPixmap pixmap = widget->grab();
+    *cost += timer.nsecsElapsed() / 1000;
+    return pixmap;
+}
+
+qint64 SplitterHandle::grabNeighbours()
+{
+    const int index = splitter()->indexOf(this);
+    qint64 cost = 0;
+    m_snapshots[0] = grabPane(splitter()->widget(index - 1), &cost);
+    m_snapshots[1] = grabPane(splitter()->widget(index), &cost);
+    return cost;
+}
+
+/**
+ * @brief SplitterHandle::paintCost
+ * The paint cost of the two neighbours. It is only measured, by grabbing
+ * them, for a new pair of neighbours or after their content changed;
+ * \a measured tells whether the snapshots were grabbed just now.
+ */
+qint64 SplitterHandle::paintCost(bool *measured)
+{
+    const int index = splitter()->indexOf(this);
+    if(m_cost >= 0 && m_costPanes[0] == splitter()->widget(index - 1)
+            && m_costPanes[1] == splitter()->widget(index))
+    {
+        *measured = false;
+        return m_cost;
+    }
+
+    *measured = true;
+    rememberCost(grabNeighbours());
+    return m_cost;
+}
+
+/**
+ * @brief SplitterHandle::rememberCost
+ * Keep \a cost for the current neighbours, whose structure changes are
+ * watched to measure again.
+ */
+void SplitterHandle::rememberCost(qint64 cost)
+{
+    const int index = splitter()->indexOf(this);
+    QWidget *panes[2] = { splitter()->widget(index - 1), splitter()->widget(index) };
+    for(int i = 0; i < 2; ++i)
+    {
+        if(m_costPanes[i] == panes[i])
+            continue;
+        if(m_costPanes[i])
+            m_costPanes[i]->removeEventFilter(this);
+        m_costPanes[i] = panes[i];
+        if(panes[i])
+            panes[i]->installEventFilter(this);
+    }
+    m_cost = cost;
+}
+
+/**
+ * @brief SplitterHandle::beginDrag
+ * AutoResize picks the mode from the paint cost of the two neighbours: panes
+ * that paint within a quarter frame follow the mouse on every move, panes
+ * that paint within a frame are throttled to the display refresh rate,
+ * anything slower is dragged as frozen snapshots.
+ */
+void SplitterHandle::beginDrag()
+{
+    m_dragging = true;
+    m_pendingPos = -1;
+    m_mode = splitter()->resizeMode();
+
+    bool grabbed = false;
+    if(m_mode == Splitter::AutoResize)
+    {
+        const qint64 cost = paintCost(&grabbed);
+        const qint64 frame = frameInterval() * 1000;
+        if(cost <= frame / 4)
+            m_mode = Splitter::OpaqueResize;
+        else if(cost <= frame)
+            m_mode = Splitter::ThrottledResize;
+        else
+            m_mode = Splitter::SnapshotResize;
+    }
+
+    // snapshot drags grab anyway, which measures the cost again for free
+    if(m_mode == Splitter::SnapshotResize && !grabbed)
+        rememberCost(grabNeighbours());
+
+    if(m_mode == Splitter::SnapshotResize && !showSnapshots())
+        m_mode = Splitter::RubberBandResize;
+    if(m_mode != Splitter::SnapshotResize)
+        m_snapshots[0] = m_snapshots[1] = QPixmap();
+}
+
+void SplitterHandle::endDrag()
+{
+    m_throttle.stop();
+    if(m_mode == Splitter::RubberBandResize)
+        splitter()->setRubberBand(-1);
+    if(m_mode == Splitter::SnapshotResize && m_cover)
+    {
+        m_cover->hide();
+        m_cover->clear();
+        m_snapshots[0] = m_snapshots[1] = QPixmap();
+    }
+
+    // the live panes are laid out once, here
+    applyPendingPosition();
+    m_dragging = false;
+}
+
+/**
+ * @brief SplitterHandle::showSnapshots
+ * The cover is a child of the splitter's parent, QSplitter would take any
+ * child widget of its own as a new pane.
+ */
+bool SplitterHandle::showSnapshots()
+{
+    const int index = splitter()->indexOf(this);
+    QWidget *first = splitter()->widget(index - 1);
+    QWidget *second = splitter()->widget(index);
+    QWidget *parent = splitter()->parentWidget();
+    if(!first || !second || !parent)
+        return false;
+
+    if(!m_cover || m_cover->parentWidget() != parent)
+    {
+        delete m_cover;
+        m_cover = new SnapshotCover(parent);
+    }
+
+    m_coverArea = first->geometry().united(second->geometry());
+    m_cover->clear();
+    m_cover->setGeometry(m_coverArea.translated(splitter()->pos()));
+    m_cover->addSnapshot(m_snapshots[0], first->geometry().translated(-m_coverArea.topLeft()));
+    m_cover->addSnapshot(m_snapshots[1], second->geometry().translated(-m_coverArea.topLeft()));
+    m_cover->setHandleRect(contentsRect().translated(geometry().topLeft() - m_coverArea.topLeft()));
+    m_cover->raise();
+    m_cover->show();
+    return true;
+}
+
+void SplitterHandle::moveSnapshots(int position)
+{
+    if(!m_cover)
+        return;
+
+    const QRect area = m_coverArea;
+    const int width = splitter()->handleWidth();
+    if(orientation() == Qt::Horizontal)
+    {
+        const int x = position - area.left();
+        m_cover->setSnapshotRect(0, QRect(0, 0, x, area.height()));
+        m_cover->setHandleRect(QRect(x, 0, width, area.height()));
+        m_cover->setSnapshotRect(1, QRect(x + width, 0, area.width() - x - width, area.height()));
+    }
+    else
+    {
+        const int y = position - area.top();
+        m_cover->setSnapshotRect(0, QRect(0, 0, area.width(), y));
+        m_cover->setHandleRect(QRect(0, y, area.width(), width));
+        m_cover->setSnapshotRect(1, QRect(0, y + width, area.width(), area.height() - y - width));
+    }
+}
+
+void SplitterHandle::applyPendingPosition()
+{
+    if(m_pendingPos < 0)
+        return;
+
+    moveSplitter(m_pendingPos);
+    m_pendingPos = -1;
+}
+
+/**
+ * @brief SplitterHandle::event
+ * The base handle repaints itself entirely on hover, but nothing painted
+ * here depends on the hover state.
+ */
+bool SplitterHandle::event(QEvent *event)
+{
+    switch (event->type())
+    {
+    case QEvent::HoverEnter:
+    case QEvent::HoverLeave:
+    case QEvent::HoverMove:
+        return true;
+    default:
+        break;
+    }
+    return QSplitterHandle::event(event);
+}
+
+/**
+ * @brief SplitterHandle::eventFilter
+ * Panes added to or removed from a neighbour, or a relayout of it, make the
+ * measured paint cost stale. Resizes do not, every drag resizes them.
+ */
+bool SplitterHandle::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type())
+    {
+    case QEvent::ChildAdded:
+    case QEvent::ChildRemoved:
+    case QEvent::LayoutRequest:
+        if(watched == m_costPanes[0] || watched == m_costPanes[1])
+            m_cost = -1;
+        break;
+    default:
+        break;
+    }
+    return QSplitterHandle::eventFilter(watched, event);
+}
+
+void SplitterHandle::mousePressEvent(QMouseEvent *event)
+{
+    // not forwarded, the base handle repaints itself on press and release
+    if(event->button() != Qt::LeftButton)
+        return;
+
+    m_offset = orientation() == Qt::Horizontal ? event->pos().x() : event->pos().y();
+    beginDrag();
+}
+
+void SplitterHandle::mouseMoveEvent(QMouseEvent *event)
+{
+    if(!(event->buttons() & Qt::LeftButton))
+        return;
+
+    // a handle grabbed by a split gesture never saw a press
+    if(!m_dragging)
+        beginDrag();
+
+    const QPoint pos = splitter()->mapFromGlobal(event->globalPos());
+    const int position = splitter()->pickHandle(pos) - m_offset;
+    switch (m_mode)
+    {
+    case Splitter::OpaqueResize:
+    case Splitter::AutoResize:
+        moveSplitter(position);
+        break;
+    case Splitter::ThrottledResize:
+        m_pendingPos = position;
+        if(!m_throttle.isActive())
+            m_throttle.start(frameInterval());
+        break;
+    case Splitter::RubberBandResize:
+        m_pendingPos = position;
+        splitter()->setRubberBand(splitter()->closestLegalPosition(position, splitter()->indexOf(this)));
+        break;
+    case Splitter::SnapshotResize:
+        m_pendingPos = splitter()->closestLegalPosition(position, splitter()->indexOf(this));
+        moveSnapshots(m_pendingPos);
+        break;
+    }
 }
 
 void SplitterHandle::mouseReleaseEvent(QMouseEvent *event)
 {
-    QSplitterHandle::mouseReleaseEvent(event);
+    if(event->button() == Qt::LeftButton && m_dragging)
+        endDrag();
+
     releaseMouse();
-    qDebug() << Q_FUNC_INFO << event->type();
 }
 
 void SplitterHandle::resizeEvent(QResizeEvent *event)
 {
-    orientation() == Qt::Horizontal ? setContentsMargins(2, 0, 2, 0)
-                                    : setContentsMargins(0, 2, 0, 2);
-    setMask(QRegion(this->contentsRect()));
-    QSplitterHandle::resizeEvent(event);
+    updateMargins();
+    // skip QSplitterHandle, it masks handles thinner than 5px
+    QWidget::resizeEvent(event);
 }
 
 void SplitterHandle::paintEvent(QPaintEvent *event)
 {
+    // the margins are left unpainted, the panes below show through
+    const QRect line = contentsRect() & event->rect();
+    if(line.isEmpty())
+        return;
+
     QPainter painter(this);
-    const QColor color("#999999");
-    painter.fillRect(event->rect(), color);
+    painter.fillRect(line, QColor("#999999"));
 }
 
 class SplitterPrivate
@@ -55,8 +396,193 @@ class SplitterPrivate
 public:
     SplitterPrivate(Splitter *q)  : q_ptr(q) {}
 
+    static int pick(Qt::Orientation orientation, const QSize &size)
+    {
+        return orientation == Qt::Horizontal ? size.width() : size.height();
+    }
+
+    /*
+     * Limits of one pane: a pane holding a nested Splitter is limited by the
+     * whole subtree below it, which that splitter keeps cached.
+     */
+    static void paneLimits(QWidget *widget, QSize *minimum, QSize *maximum)
+    {
+        *minimum = widget->minimumSize();
+        *maximum = widget->maximumSize();
+
+        auto pane = qobject_cast<Splittable *>(widget);
+        auto nested = pane ? qobject_cast<Splitter *>(pane->splitter()) : nullptr;
+        if(!nested)
+            return;
+
+        *minimum = minimum->expandedTo(nested->minimumContentSize());
+        *maximum = maximum->boundedTo(nested->maximumContentSize());
+    }
+
+    void updateLimits() const
+    {
+        if(limitsValid)
+            return;
+
+        const Qt::Orientation orientation = q_ptr->orientation();
+        qint64 minimumAlong = 0;
+        qint64 maximumAlong = 0;
+        int minimumAcross = 0;
+        int maximumAcross = QWIDGETSIZE_MAX;
+        int visible = 0;
+        for(int i = 0; i < q_ptr->count(); ++i)
+        {
+            QWidget *widget = q_ptr->widget(i);
+            if(widget->isHidden())
+                continue;
+
+            QSize minimum, maximum;
+            paneLimits(widget, &minimum, &maximum);
+            minimumAlong += pick(orientation, minimum);
+            maximumAlong += pick(orientation, maximum);
+            const Qt::Orientation across = orientation == Qt::Horizontal ? Qt::Vertical : Qt::Horizontal;
+            minimumAcross = qMax(minimumAcross, pick(across, minimum));
+            maximumAcross = qMin(maximumAcross, pick(across, maximum));
+            ++visible;
+        }
+
+        const int handles = qMax(0, visible - 1) * q_ptr->handleWidth();
+        const int along = int(qMin<qint64>(minimumAlong + handles, QWIDGETSIZE_MAX));
+        const int alongMaximum = int(qMin<qint64>(maximumAlong + handles, QWIDGETSIZE_MAX));
+        minimumSize = orientation == Qt::Horizontal ? QSize(along, minimumAcross) : QSize(minimumAcross, along);
+        maximumSize = orientation == Qt::Horizontal ? QSize(alongMaximum, maximumAcross)
+                                                    : QSize(maximumAcross, alongMaximum);
+        limitsValid = true;
+    }
+
+    // the extent shared by the visible panes, hidden ones take no handle
+    int availableExtent() const
+    {
+        int visible = 0;
+        for(int i = 0; i < q_ptr->count(); ++i)
+            visible += q_ptr->widget(i)->isHidden() ? 0 : 1;
+        const int handles = qMax(0, visible - 1) * q_ptr->handleWidth();
+        return qMax(0, q_ptr->pickHandle(q_ptr->contentsRect().size()) - handles);
+    }
+
+    // ratios follow sizes changed by something else, a handle drag or setSizes()
+    void syncRatios()
+    {
+        const QList<int> current = q_ptr->sizes();
+        if(current != solved || ratios.count() != q_ptr->count())
+        {
+            captureRatios(current);
+            solved = current;
+        }
+    }
+
+    void captureRatios(const QList<int> &sizes)
+    {
+        qint64 total = 0;
+        for(int size : sizes)
+            total += size;
+
+        ratios.resize(sizes.count());
+        for(int i = 0; i < sizes.count(); ++i)
+            ratios[i] = total > 0 ? qreal(sizes[i]) / total : qreal(1) / sizes.count();
+    }
+
+    /*
+     * One pass over the panes: every edge is the rounded cumulative ratio of
+     * the available extent, so sizes never drift however often they are
+     * solved, then panes outside their limits are clamped and the
+     * difference is diffused over the others in proportion to their room.
+     */
+    QList<int> solve(int available) const
+    {
+        const int count = q_ptr->count();
+        QVarLengthArray<int, 16> sizes(count);
+        QVarLengthArray<int, 16> minimums(count);
+        QVarLengthArray<int, 16> maximums(count);
+        const Qt::Orientation orientation = q_ptr->orientation();
+
+        // hidden panes keep their ratio but take no space
+        qreal total = 0;
+        for(int i = 0; i < count; ++i)
+            total += q_ptr->widget(i)->isHidden() ? 0 : ratios.value(i);
+        if(total <= 0)
+            total = 1;
+
+        qreal cumulative = 0;
+        int previous = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            QWidget *widget = q_ptr->widget(i);
+            if(widget->isHidden())
+            {
+                sizes[i] = minimums[i] = maximums[i] = 0;
+                continue;
+            }
+
+            cumulative += ratios.value(i) / total;
+            const int edge = qRound(cumulative * available);
+            sizes[i] = edge - previous;
+            previous = edge;
+
+            QSize minimum, maximum;
+            paneLimits(widget, &minimum, &maximum);
+            minimums[i] = pick(orientation, minimum);
+            maximums[i] = qMax(minimums[i], pick(orientation, maximum));
+        }
+
+        diffuse(sizes, minimums, maximums);
+
+        QList<int> result;
+        result.reserve(count);
+        for(int size : sizes)
+            result.append(size);
+        return result;
+    }
+
+    static void diffuse(QVarLengthArray<int, 16> &sizes, const QVarLengthArray<int, 16> &minimums,
+                        const QVarLengthArray<int, 16> &maximums)
+    {
+        // clamp, the balance is positive when panes were raised to their minimum
+        int balance = 0;
+        for(int k = 0; k < sizes.count(); ++k)
+        {
+            const int clamped = qBound(minimums[k], sizes[k], maximums[k]);
+            balance += clamped - sizes[k];
+            sizes[k] = clamped;
+        }
+        if(balance == 0)
+            return;
+
+        // panes strictly inside their limits absorb the balance
+        qint64 room = 0;
+        for(int k = 0; k < sizes.count(); ++k)
+            room += balance > 0 ? sizes[k] - minimums[k] : maximums[k] - sizes[k];
+        if(room <= 0)
+            return;
+
+        const qint64 take = qMin<qint64>(qAbs(balance), room);
+        qint64 error = 0;
+        for(int k = 0; k < sizes.count(); ++k)
+        {
+            const int slack = balance > 0 ? sizes[k] - minimums[k] : maximums[k] - sizes[k];
+            if(slack <= 0)
+                continue;
+            const qint64 scaled = qint64(slack) * take + error;
+            const int share = int(scaled / room);
+            error = scaled - qint64(share) * room;
+            sizes[k] += balance > 0 ? -share : share;
+        }
+    }
+
     Splitter *q_ptr;
     SplitterHandle *handle = nullptr;
+    Splitter::ResizeMode resizeMode = Splitter::AutoResize;
+
+    QVector<qreal> ratios;
+    QList<int> solved;
+    mutable QSize minimumSize;
+    mutable QSize maximumSize;
+    mutable bool limitsValid = false;
 };
 
 /**
@@ -72,6 +598,8 @@ Splitter::Splitter(QWidget *parent)
     setObjectName("Splitter");
     setHandleWidth(1);
     setChildrenCollapsible(false);
+    // the handles implement the resize modes themselves
+    setOpaqueResize(true);
 }
 
 Splitter::Splitter(Qt::Orientation orientation, QWidget *parent)
@@ -81,6 +609,18 @@ Splitter::Splitter(Qt::Orientation orientation, QWidget *parent)
     setObjectName("Splitter");
     setHandleWidth(1);
     setChildrenCollapsible(false);
+    // the handles implement the resize modes themselves
+    setOpaqueResize(true);
+}
+
+void Splitter::setResizeMode(ResizeMode mode)
+{
+    d->resizeMode = mode;
+}
+
+Splitter::ResizeMode Splitter::resizeMode() const
+{
+    return d->resizeMode;
 }
 
 QSplitterHandle *Splitter::createHandle()
@@ -89,6 +629,96 @@ QSplitterHandle *Splitter::createHandle()
     return  d->handle;
 }
 
+/**
+ * @brief Splitter::ratios
+ * @return the share of the available extent of each pane, they add up to 1
+ */
+QVector<qreal> Splitter::ratios() const
+{
+    d->syncRatios();
+    return d->ratios;
+}
+
+void Splitter::setRatios(const QVector<qreal> &ratios)
+{
+    qreal total = 0;
+    for(qreal ratio : ratios)
+        total += qMax<qreal>(0, ratio);
+    if(ratios.count() != count() || total <= 0)
+        return;
+
+    d->ratios.resize(ratios.count());
+    for(int i = 0; i < ratios.count(); ++i)
+        d->ratios[i] = qMax<qreal>(0, ratios[i]) / total;
+
+    setSizes(d->solve(d->availableExtent()));
+    d->solved = sizes();
+}
+
+/**
+ * @brief Splitter::minimumContentSize
+ * @return the smallest size the panes of this splitter and every nested
+ * splitter below it fit in, cached until a pane is added, removed or asks
+ * for a new layout
+ */
+QSize Splitter::minimumContentSize() const
+{
+    d->updateLimits();
+    return d->minimumSize;
+}
+
+QSize Splitter::maximumContentSize() const
+{
+    d->updateLimits();
+    return d->maximumSize;
+}
+
+/**
+ * @brief Splitter::invalidateConstraints
+ * Drop the cached limits of this splitter and of the splitters above it,
+ * stopping at the first one already invalid.
+ */
+void Splitter::invalidateConstraints()
+{
+    for(Splitter *splitter = this; splitter && splitter->d->limitsValid; )
+    {
+        splitter->d->limitsValid = false;
+        QWidget *pane = splitter->parentWidget();
+        splitter = pane ? qobject_cast<Splitter *>(pane->parentWidget()) : nullptr;
+    }
+}
+
+/**
+ * @brief Splitter::resizeEvent
+ * Sizes are solved from the stored ratios instead of rescaling the previous
+ * integer sizes as QSplitter does. Ratios are captured again only when the
+ * sizes were changed by something else, a handle drag or setSizes().
+ */
+void Splitter::resizeEvent(QResizeEvent *event)
+{
+    d->syncRatios();
+
+    // setSizes lays the panes out once, the base resizeEvent would do it again
+    setSizes(d->solve(d->availableExtent()));
+    d->solved = sizes();
+    QFrame::resizeEvent(event);
+}
+
+void Splitter::childEvent(QChildEvent *event)
+{
+    if(event->added() || event->removed())
+        invalidateConstraints();
+    QSplitter::childEvent(event);
+}
+
+bool Splitter::event(QEvent *event)
+{
+    // a pane changed its minimum or maximum size
+    if(event->type() == QEvent::LayoutRequest)
+        invalidateConstraints();
+    return QSplitter::event(event);
+}
+
 void Splitter::paintEvent(QPaintEvent *event)
 {
 //    auto palette = this->palette();
@@ -2,16 +2,38 @@
 #define SPLITTER_H
 
 #include <QSplitter>
+#include <QVector>
 
 class SplitterPrivate;
 class Splitter : public QSplitter
 {
     Q_OBJECT
     Q_DECLARE_PRIVATE_D(d, Splitter)
+    Q_PROPERTY(ResizeMode resizeMode READ resizeMode WRITE setResizeMode)
 public:
+    enum ResizeMode
+    {
+        OpaqueResize = 0,   // relayout on every mouse move
+        ThrottledResize,    // relayout at most once per display frame
+        RubberBandResize,   // preview with a rubber band, apply on release
+        SnapshotResize,     // drag frozen snapshots of the panes, apply on release
+        AutoResize          // chosen per drag from the paint cost of the panes
+    };
+    Q_ENUM(ResizeMode)
+
     explicit Splitter(QWidget *parent = nullptr);
     explicit Splitter(Qt::Orientation orientation, QWidget *parent = nullptr);
 
+    void setResizeMode(ResizeMode mode);
+    ResizeMode resizeMode() const;
+
+    QVector<qreal> ratios() const;
+    void setRatios(const QVector<qreal> &ratios);
+
+    QSize minimumContentSize() const;
+    QSize maximumContentSize() const;
+    void invalidateConstraints();
+
     inline int pickHandle(const QPoint &pos) const
     { return this->orientation() == Qt::Horizontal ? pos.x() : pos.y(); }
 
@@ -27,8 +49,12 @@ public:
 protected:
     QSplitterHandle *createHandle();
     void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event) override;
+    void childEvent(QChildEvent *event) override;
+    bool event(QEvent *event) override;
 
 private:
+    friend class SplitterHandle;
     QScopedPointer<SplitterPrivate> d;
 };
 
@@ -1,37 +1,24 @@
 #include "TitleBar.h"
 
-#include <QHBoxLayout>
-#include <QSpacerItem>
-
-#include <QComboBox>
-#include <QLabel>
-#include <QStylePainter>
-#include <QVariant>
+#include <QApplication>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QPointer>
+#include <QStyle>
 #include <QStyleOptionToolBar>
+#include <QVariant>
+
+static const int Margin = 10;
+static const int Spacing = 8;
+static const int ArrowSize = 8;
 
 TitleBar::TitleBar(QWidget *parent) : QWidget(parent)
 {
     setProperty("panelwidget_multiple_row", true);
     setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Minimum);
     setMaximumHeight(32);
-
-    auto layout = new QHBoxLayout;
-    layout->setContentsMargins(10, 0, 10, 0);
-    layout->setSpacing(0);
-    this->setLayout(layout);
-
-    // just test
-    auto combobox1 = new QComboBox(this);
-    combobox1->addItem("Align Top");
-    combobox1->addItem("Align Bottom");
-    m_titleLabel = new QLabel("Title Bar", this);
-    layout->addWidget(combobox1);
-    layout->addWidget(m_titleLabel);
-
-    connect(combobox1, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index)
-    {
-        index == 0 ? setAlignment(Qt::AlignTop) : setAlignment(Qt::AlignBottom);
-    });
 }
 
 void TitleBar::setMultipleRow(bool multiple)
@@ -50,15 +37,21 @@ void TitleBar::setAlignment(Qt::Alignment alignment)
         return;
 
     m_alignment = alignment;
+    m_selectorWidth = -1;
+    // the selector width changes, so the title moves and the size hint too
+    update();
+    updateGeometry();
     emit alignmentChanged(m_alignment);
 }
 
 void TitleBar::setTitle(const QString &title)
 {
-    if(title == m_titleLabel->text())
+    if(title == m_title)
         return;
 
-    m_titleLabel->setText(title);
+    m_title = title;
+    update(QRect(selectorRect().right() + 1, 0, width(), height()));
+    updateGeometry();
     emit titleChanged(title);
 }
 
@@ -69,22 +62,162 @@ Qt::Alignment TitleBar::alignment() const
 
 QString TitleBar::title() const
 {
-    return m_titleLabel->text();
+    return m_title;
+}
+
+QSize TitleBar::sizeHint() const
+{
+    const QFontMetrics metrics = fontMetrics();
+    const int width = Margin * 2 + selectorRect().width() + Spacing + metrics.horizontalAdvance(m_title);
+    return QSize(width, qMin(maximumHeight(), metrics.height() + 12));
+}
+
+QSize TitleBar::minimumSizeHint() const
+{
+    return QSize(0, sizeHint().height());
+}
+
+/**
+ * @brief TitleBar::alignmentMenu
+ * One menu for all title bars, created the first time any selector is
+ * clicked. The caller reads the chosen action, so the menu keeps no state.
+ */
+QMenu *TitleBar::alignmentMenu()
+{
+    static QPointer<QMenu> menu;
+    if(!menu)
+    {
+        menu = new QMenu;
+        QObject::connect(qApp, &QCoreApplication::aboutToQuit, menu, &QObject::deleteLater);
+        QAction *top = menu->addAction(tr("Align Top"));
+        top->setData(int(Qt::AlignTop));
+        top->setCheckable(true);
+        QAction *bottom = menu->addAction(tr("Align Bottom"));
+        bottom->setData(int(Qt::AlignBottom));
+        bottom->setCheckable(true);
+    }
+    return menu;
+}
+
+QString TitleBar::alignmentText() const
+{
+    return m_alignment == Qt::AlignBottom ? tr("Align Bottom") : tr("Align Top");
+}
+
+QRect TitleBar::selectorRect() const
+{
+    if(m_selectorWidth < 0)
+        m_selectorWidth = fontMetrics().horizontalAdvance(alignmentText()) + Spacing + ArrowSize;
+    return QRect(Margin, 0, m_selectorWidth, height());
+}
+
+/**
+ * @brief TitleBar::background
+ * The toolbar background only depends on the size, the style and the
+ * device pixel ratio, so it is drawn once per combination and shared by
+ * all title bars of the same size.
+ */
+QPixmap TitleBar::background() const
+{
+    const qreal ratio = devicePixelRatioF();
+    const QString key = QStringLiteral("titlebar:%1x%2:%3:%4")
+            .arg(width()).arg(height())
+            .arg(quintptr(style())).arg(ratio);
+
+    QPixmap pixmap;
+    if(QPixmapCache::find(key, &pixmap))
+        return pixmap;
+
+    pixmap = QPixmap(size() * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter painter(&pixmap);
+        QStyleOptionToolBar option;
+        option.initFrom(this);
+        option.rect = rect();
+        option.state = QStyle::State_Horizontal;
+        style()->drawControl(QStyle::CE_ToolBar, &option, &painter, this);
+    }
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+void TitleBar::showAlignmentMenu()
+{
+    QMenu *menu = alignmentMenu();
+    const auto actions = menu->actions();
+    for(QAction *action : actions)
+        action->setChecked(action->data().toInt() == int(m_alignment));
+
+    QPointer<TitleBar> self(this);
+    QAction *chosen = menu->exec(mapToGlobal(selectorRect().bottomLeft()));
+    // the pane may have been closed while the menu was open
+    if(chosen && self)
+        setAlignment(Qt::Alignment(chosen->data().toInt()));
 }
 
 void TitleBar::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event)
 
-//    QStylePainter painter(this);
-//    QStyleOptionToolBar option;
-//    option.rect = rect();
-//    option.state = QStyle::State_Horizontal;
-//    painter.drawControl(QStyle::CE_ToolBar, option);
-
     QPainter painter(this);
-    QStyleOptionToolBar option;
-    option.rect = rect();
-    option.state = QStyle::State_Horizontal;
-    style()->drawControl(QStyle::CE_ToolBar, &option, &painter, this);
+    painter.drawPixmap(0, 0, background());
+
+    const QRect selector = selectorRect();
+    const QRect text = selector.adjusted(0, 0, -(Spacing + ArrowSize), 0);
+    painter.setPen(palette().color(QPalette::ButtonText));
+    painter.drawText(text, Qt::AlignLeft | Qt::AlignVCenter, alignmentText());
+
+    QStyleOption arrow;
+    arrow.initFrom(this);
+    arrow.rect = QRect(selector.right() - ArrowSize + 1, (height() - ArrowSize) / 2, ArrowSize, ArrowSize);
+    style()->drawPrimitive(QStyle::PE_IndicatorArrowDown, &arrow, &painter, this);
+
+    const QRect title(selector.right() + 1 + Spacing, 0, width() - selector.right() - 1 - Spacing - Margin, height());
+    painter.setPen(palette().color(QPalette::WindowText));
+    painter.drawText(title, Qt::AlignLeft | Qt::AlignVCenter,
+                     fontMetrics().elidedText(m_title, Qt::ElideRight, title.width()));
+}
+
+void TitleBar::mousePressEvent(QMouseEvent *event)
+{
+    if(event->button() == Qt::LeftButton && selectorRect().contains(event->pos()))
+    {
+        showAlignmentMenu();
+        return;
+    }
+
+    // anywhere else the title bar is the handle to drag the pane by
+    m_pressed = event->button() == Qt::LeftButton;
+    m_pressPos = event->pos();
+    QWidget::mousePressEvent(event);
+}
+
+void TitleBar::mouseMoveEvent(QMouseEvent *event)
+{
+    if(m_pressed && (event->buttons() & Qt::LeftButton)
+            && (event->pos() - m_pressPos).manhattanLength() >= QApplication::startDragDistance())
+    {
+        m_pressed = false;
+        emit dragRequested();
+        return;
+    }
+    QWidget::mouseMoveEvent(event);
+}
+
+void TitleBar::mouseReleaseEvent(QMouseEvent *event)
+{
+    m_pressed = false;
+    QWidget::mouseReleaseEvent(event);
+}
+
+void TitleBar::changeEvent(QEvent *event)
+{
+    if(event->type() == QEvent::FontChange || event->type() == QEvent::StyleChange)
+    {
+        m_selectorWidth = -1;
+        updateGeometry();
+    }
+    QWidget::changeEvent(event);
 }
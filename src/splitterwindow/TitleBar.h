@@ -4,7 +4,13 @@
 #include <QObject>
 #include <QWidget>
 
-class QLabel;
+class QMenu;
+
+/**
+ * @brief The TitleBar class
+ * Paints its title and alignment selector itself, the selector menu is one
+ * popup shared by every title bar and only shown when clicked.
+ */
 class TitleBar : public QWidget
 {
     Q_OBJECT
@@ -17,9 +23,13 @@ public:
     Qt::Alignment alignment() const;
     QString title() const;
 
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
 signals:
     void alignmentChanged(Qt::Alignment alignment);
     void titleChanged(const QString &title);
+    void dragRequested();
 
 public slots:
     void setAlignment(Qt::Alignment alignment);
@@ -27,10 +37,23 @@ public slots:
 
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
 private:
+    static QMenu *alignmentMenu();
+    QString alignmentText() const;
+    QRect selectorRect() const;
+    QPixmap background() const;
+    void showAlignmentMenu();
+
     Qt::Alignment m_alignment = Qt::AlignTop;
-    QLabel *m_titleLabel;
+    QString m_title = QStringLiteral("Title Bar");
+    mutable int m_selectorWidth = -1;
+    QPoint m_pressPos;
+    bool m_pressed = false;
 };
 
 #endif // TITLEBAR_H
@@ -1,6 +1,9 @@
 #include "Viewport.h"
 #include "TitleBar.h"
+#include "Splittable.h"
+#include "SplitTransaction.h"
 
+#include <QApplication>
 #include <QStackedWidget>
 #include <QVBoxLayout>
 #include <QMouseEvent>
@@ -8,9 +11,39 @@
 #include <QLabel>
 #include <QDrag>
 #include <QMimeData>
+#include <QRubberBand>
 #include <QtMath>
 #include <QDebug>
 
+/*
+ * All viewports share one palette and font instead of a per-widget style
+ * sheet, so creating a pane does not spin up a QStyleSheetStyle and re-polish
+ * the whole subtree. QPalette and QFont are implicitly shared, setting them on
+ * every container only copies a reference.
+ */
+static const QPalette &viewportPalette()
+{
+    static const QPalette palette = [] {
+        QPalette palette = QApplication::palette();
+        palette.setColor(QPalette::Window, QColor("#333333"));
+        palette.setColor(QPalette::Base, QColor("#333333"));
+        palette.setColor(QPalette::WindowText, QColor("#999999"));
+        palette.setColor(QPalette::Text, QColor("#999999"));
+        return palette;
+    }();
+    return palette;
+}
+
+static const QFont &viewportFont()
+{
+    static const QFont font = [] {
+        QFont font = QApplication::font();
+        font.setPixelSize(20);
+        return font;
+    }();
+    return font;
+}
+
 Viewport::Viewport(Splittable *splittable, QWidget *parent)
     : QWidget(parent)
     , m_splittable(splittable)
@@ -29,15 +62,24 @@ Viewport::Viewport(Splittable *splittable, QWidget *parent)
             else
                 this->setLayoutDirection(QBoxLayout::BottomToTop);
         });
+        connect(m_titleBar, &TitleBar::dragRequested, this, [this] { startDrag(); });
+        // only this view's copy of the content detaches
+        connect(m_titleBar, &TitleBar::titleChanged, this, [this](const QString &title) {
+            m_content.setTitle(title);
+        });
     }
 
     m_layout->addWidget(m_titleBar);
     m_layout->addWidget(m_container);
+    setAcceptDrops(true);
 
-    m_container->setStyleSheet("background-color: #333333; color: #999999; font-size: 20px");
+    m_container->setAutoFillBackground(true);
+    m_container->setPalette(viewportPalette());
+    m_container->setFont(viewportFont());
     QLabel *label = new QLabel("Splittable\n Viewport");
     label->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-    m_container->addWidget(label);
+    m_placeholder = label;
+    addWidget(label);
 }
 
 Viewport::~Viewport()
@@ -70,13 +112,40 @@ void Viewport::setLayoutDirection(QBoxLayout::Direction direction) const
     m_layout->setDirection(direction);
 }
 
-void Viewport::addWidget(QWidget *widget)
+/**
+ * @brief Viewport::addWidget
+ * Add \a widget as a new page and show it. A page with a \a key may be
+ * evicted later and is then recreated through the page factory.
+ */
+void Viewport::addWidget(QWidget *widget, const QString &key)
 {
-    if((m_container->indexOf(widget)) != -1)
-        return;
+    Q_ASSERT(widget != nullptr);
+    for(int i = 0; i < m_pages.count(); ++i)
+    {
+        if(m_pages[i].widget == widget)
+            return setCurrentWidget(i);
+    }
 
+    Page page;
+    page.key = key;
+    page.widget = widget;
+    m_pages.append(page);
     m_container->addWidget(widget);
-    m_container->setCurrentWidget(widget);
+    setCurrentWidget(m_pages.count() - 1);
+}
+
+/**
+ * @brief Viewport::addPage
+ * Add a page that is created by the page factory the first time it is shown.
+ * @return the index of the page
+ */
+int Viewport::addPage(const QString &key)
+{
+    Q_ASSERT(!key.isEmpty());
+    Page page;
+    page.key = key;
+    m_pages.append(page);
+    return m_pages.count() - 1;
 }
 
 QWidget *Viewport::widget() const
@@ -86,18 +155,407 @@ QWidget *Viewport::widget() const
 
 void Viewport::setCurrentWidget(int index)
 {
-    Q_ASSERT(index >= 0 && index < m_container->count());
-    m_container->setCurrentIndex(index);
+    Q_ASSERT(index >= 0 && index < m_pages.count());
+    QWidget *widget = ensurePage(index);
+    if(!widget)
+        return;
+
+    /* Only the current page is ever suspended: the page switched away from
+     * is resumed, the one shown while suspended is suspended as well. */
+    if(m_suspended && index != m_current)
+    {
+        QWidget *previous = m_current >= 0 && m_current < m_pages.count()
+                ? m_pages[m_current].widget.data() : nullptr;
+        if(previous && previous != widget)
+        {
+            QEvent resume(Splittable::ResumeEvent);
+            QCoreApplication::sendEvent(previous, &resume);
+        }
+        QEvent event(Splittable::SuspendEvent);
+        QCoreApplication::sendEvent(widget, &event);
+    }
+
+    m_current = index;
+    m_dragPixmapDirty = true;
+    m_pages[index].used = ++m_clock;
+    m_container->setCurrentWidget(widget);
+    evictPages();
 }
 
 void Viewport::setCurrentWidget(QWidget *widget)
 {
     Q_ASSERT(widget != nullptr);
-    m_container->setCurrentWidget(widget);
+    for(int i = 0; i < m_pages.count(); ++i)
+    {
+        if(m_pages[i].widget == widget)
+            return setCurrentWidget(i);
+    }
+}
+
+int Viewport::currentIndex() const
+{
+    return m_current;
+}
+
+int Viewport::pageCount() const
+{
+    return m_pages.count();
+}
+
+int Viewport::livePageCount() const
+{
+    return m_container->count();
+}
+
+QString Viewport::pageKey(int index) const
+{
+    return m_pages.value(index).key;
+}
+
+bool Viewport::isPageLive(int index) const
+{
+    return index >= 0 && index < m_pages.count() && m_pages[index].widget;
+}
+
+void Viewport::setPageFactory(const PageFactory &factory)
+{
+    m_pageFactory = factory;
+}
+
+/**
+ * @brief Viewport::setMaximumLivePages
+ * Keep at most \a count pages alive, 0 keeps all of them. The current page
+ * and pages without a key are never evicted.
+ */
+void Viewport::setMaximumLivePages(int count)
+{
+    m_maximumLivePages = qMax(0, count);
+    evictPages();
+}
+
+int Viewport::maximumLivePages() const
+{
+    return m_maximumLivePages;
+}
+
+QWidget *Viewport::ensurePage(int index)
+{
+    Page &page = m_pages[index];
+    if(page.widget)
+        return page.widget;
+
+    if(const QSharedPointer<ContentProvider> provider = m_providers.value(page.key))
+        page.widget = provider->createView(m_container);
+    else if(m_pageFactory)
+        page.widget = m_pageFactory(page.key, m_container);
+    if(page.widget)
+        m_container->addWidget(page.widget);
+    return page.widget;
+}
+
+/*
+ * Drop the least recently shown pages until the live count fits. Page counts
+ * per pane are small, a linear scan for the oldest page is cheaper than
+ * keeping an ordered list up to date on every switch.
+ */
+void Viewport::evictPages()
+{
+    if(m_maximumLivePages <= 0)
+        return;
+
+    while(m_container->count() > m_maximumLivePages)
+    {
+        int oldest = -1;
+        for(int i = 0; i < m_pages.count(); ++i)
+        {
+            const Page &page = m_pages[i];
+            if(i == m_current || !page.widget || page.key.isEmpty())
+                continue;
+            if(!m_pageFactory && !m_providers.contains(page.key))
+                continue;
+            if(oldest < 0 || page.used < m_pages[oldest].used)
+                oldest = i;
+        }
+        if(oldest < 0)
+            return;
+
+        QWidget *widget = m_pages[oldest].widget;
+        m_pages[oldest].widget = nullptr;
+        m_container->removeWidget(widget);
+        widget->deleteLater();
+    }
+}
+
+/**
+ * @brief Viewport::setContent
+ * Show a view created by the provider of \a content. The view is a keyed
+ * page, when it is evicted it is created again from the same provider
+ * rather than through the page factory.
+ */
+void Viewport::setContent(const ViewportContent &content)
+{
+    m_content = content;
+    m_dragPixmapDirty = true;
+    m_titleBar->setTitle(m_content.title());
+    emit contentChanged();
+
+    const QSharedPointer<ContentProvider> provider = m_content.provider();
+    if(!provider)
+        return;
+
+    const QString key = provider->key();
+    m_providers.insert(key, provider);
+    for(int i = 0; i < m_pages.count(); ++i)
+    {
+        if(m_pages[i].key == key)
+            return setCurrentWidget(i);
+    }
+
+    if(QWidget *view = provider->createView(m_container))
+        addWidget(view, key);
+
+    // the placeholder is only shown until there is real content
+    if(m_placeholder && m_placeholder != widget())
+    {
+        for(int i = 0; i < m_pages.count(); ++i)
+        {
+            if(m_pages[i].widget != m_placeholder)
+                continue;
+            m_pages.remove(i);
+            if(m_current > i)
+                --m_current;
+            break;
+        }
+        m_container->removeWidget(m_placeholder);
+        m_placeholder->deleteLater();
+    }
 }
 
+ViewportContent Viewport::content() const
+{
+    return m_content;
+}
+
+/**
+ * @brief Viewport::duplicate
+ * A new viewport over the same content: the provider, its model and its
+ * cached resources are shared, not copied. The caller takes ownership.
+ */
 Viewport *Viewport::duplicate()
 {
-    // TODO: IMPL
-    return nullptr;
+    auto viewport = new Viewport(nullptr);
+    // a plain viewport has no content, only the title shown in its bar
+    if(m_content.provider())
+        viewport->setContent(m_content);
+    else
+        viewport->m_titleBar->setTitle(m_titleBar->title());
+    viewport->m_titleBar->setAlignment(m_titleBar->alignment());
+    return viewport;
+}
+
+bool Viewport::isSuspended() const
+{
+    return m_suspended;
+}
+
+/**
+ * @brief Viewport::event
+ * A suspended viewport stops repainting its pages and passes the
+ * notification on to the current page, which can stop its own timers.
+ */
+bool Viewport::event(QEvent *event)
+{
+    if(event->type() == Splittable::SuspendEvent || event->type() == Splittable::ResumeEvent)
+    {
+        const bool suspended = event->type() == Splittable::SuspendEvent;
+        if(suspended == m_suspended)
+            return true;
+
+        m_suspended = suspended;
+        m_container->setUpdatesEnabled(!suspended);
+        if(QWidget *page = widget())
+            QCoreApplication::sendEvent(page, event);
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+QString Viewport::paneMimeType()
+{
+    return QStringLiteral("application/x-splittable-pane");
+}
+
+void Viewport::resizeEvent(QResizeEvent *event)
+{
+    m_dragPixmapDirty = true;
+    QWidget::resizeEvent(event);
+}
+
+void Viewport::startDrag()
+{
+    if(!m_splittable)
+        return;
+
+    auto mime = new QMimeData;
+    mime->setData(paneMimeType(), QByteArray::number(m_splittable->paneId()));
+
+    const QPixmap pixmap = dragPixmap();
+    QDrag *drag = new QDrag(this);
+    drag->setMimeData(mime);
+    drag->setPixmap(pixmap);
+    drag->setHotSpot(QPoint(pixmap.width(), pixmap.height()) / (2 * pixmap.devicePixelRatio()));
+    drag->exec(Qt::MoveAction);
+}
+
+/**
+ * @brief Viewport::dragPixmap
+ * A scaled-down grab of the viewport, only grabbed again after the size, the
+ * page or the content changed. Dragging the same pane twice grabs once.
+ */
+QPixmap Viewport::dragPixmap()
+{
+    if(!m_dragPixmapDirty && !m_dragPixmap.isNull())
+        return m_dragPixmap;
+
+    const qreal ratio = devicePixelRatioF();
+    const QSize extent = (size() * ratio).scaled(QSize(240, 240) * ratio, Qt::KeepAspectRatio);
+    m_dragPixmap = grab().scaled(extent, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    m_dragPixmap.setDevicePixelRatio(ratio);
+    m_dragPixmapDirty = false;
+    return m_dragPixmap;
+}
+
+/*
+ * Only panes of the same tree are accepted, the drag carries a pane id that
+ * is resolved through the tree's registry.
+ */
+Splittable *Viewport::dragSource(const QMimeData *mime) const
+{
+    if(!m_splittable || !mime || !mime->hasFormat(paneMimeType()))
+        return nullptr;
+
+    bool ok = false;
+    const int id = mime->data(paneMimeType()).toInt(&ok);
+    Splittable *source = ok ? m_splittable->registry()->pane(id) : nullptr;
+    return source != m_splittable ? source : nullptr;
+}
+
+Viewport::DropZone Viewport::dropZone(const QPoint &pos) const
+{
+    if(!rect().contains(pos))
+        return NoDrop;
+
+    // the outer quarter on each side is an edge, the rest is the centre
+    const int x = pos.x() * 4 / qMax(1, width());
+    const int y = pos.y() * 4 / qMax(1, height());
+    if(x > 0 && x < 3 && y > 0 && y < 3)
+        return CentreDrop;
+
+    const int left = pos.x();
+    const int top = pos.y();
+    const int right = width() - pos.x();
+    const int bottom = height() - pos.y();
+    const int nearest = qMin(qMin(left, right), qMin(top, bottom));
+    if(nearest == left)
+        return LeftDrop;
+    if(nearest == right)
+        return RightDrop;
+    return nearest == top ? TopDrop : BottomDrop;
+}
+
+QRect Viewport::dropRect(DropZone zone) const
+{
+    const QRect area = rect();
+    switch (zone)
+    {
+    case LeftDrop:
+        return area.adjusted(0, 0, -area.width() / 2, 0);
+    case RightDrop:
+        return area.adjusted(area.width() / 2, 0, 0, 0);
+    case TopDrop:
+        return area.adjusted(0, 0, 0, -area.height() / 2);
+    case BottomDrop:
+        return area.adjusted(0, area.height() / 2, 0, 0);
+    case CentreDrop:
+        return area.adjusted(area.width() / 4, area.height() / 4, -area.width() / 4, -area.height() / 4);
+    default:
+        return QRect();
+    }
+}
+
+void Viewport::showDropIndicator(DropZone zone)
+{
+    if(zone == NoDrop)
+    {
+        if(m_dropIndicator)
+            m_dropIndicator->hide();
+        return;
+    }
+
+    if(!m_dropIndicator)
+        m_dropIndicator = new QRubberBand(QRubberBand::Rectangle, this);
+    m_dropIndicator->setGeometry(dropRect(zone));
+    m_dropIndicator->raise();
+    m_dropIndicator->show();
+}
+
+void Viewport::dragEnterEvent(QDragEnterEvent *event)
+{
+    if(!dragSource(event->mimeData()))
+        return event->ignore();
+
+    event->acceptProposedAction();
+    showDropIndicator(dropZone(event->pos()));
+}
+
+void Viewport::dragMoveEvent(QDragMoveEvent *event)
+{
+    const DropZone zone = dragSource(event->mimeData()) ? dropZone(event->pos()) : NoDrop;
+    showDropIndicator(zone);
+    if(zone == NoDrop)
+        event->ignore();
+    else
+        event->acceptProposedAction();
+}
+
+void Viewport::dragLeaveEvent(QDragLeaveEvent *event)
+{
+    showDropIndicator(NoDrop);
+    QWidget::dragLeaveEvent(event);
+}
+
+void Viewport::dropEvent(QDropEvent *event)
+{
+    showDropIndicator(NoDrop);
+    Splittable *source = dragSource(event->mimeData());
+    const DropZone zone = dropZone(event->pos());
+    if(!source || zone == NoDrop)
+        return event->ignore();
+
+    SplitTransaction transaction = m_splittable->transaction();
+    const int from = source->paneId();
+    const int to = m_splittable->paneId();
+    switch (zone)
+    {
+    case LeftDrop:
+        transaction.move(from, to, Qt::Horizontal, 0);
+        break;
+    case RightDrop:
+        transaction.move(from, to, Qt::Horizontal, 1);
+        break;
+    case TopDrop:
+        transaction.move(from, to, Qt::Vertical, 0);
+        break;
+    case BottomDrop:
+        transaction.move(from, to, Qt::Vertical, 1);
+        break;
+    default:
+        transaction.swap(from, to);
+        break;
+    }
+
+    if(transaction.commit())
+        event->acceptProposedAction();
+    else
+        event->ignore();
 }
@@ -3,16 +3,37 @@
 
 #include <QWidget>
 #include <QBoxLayout>
+#include <QHash>
+#include <QPixmap>
+#include <QPointer>
+#include <QVector>
 
+#include "ViewportContent.h"
+
+#include <functional>
+
+class QRubberBand;
 class QStackedWidget;
 class QVBoxLayout;
 class TitleBar;
 class Splittable;
 
+/**
+ * @brief The Viewport class
+ * Shows one page of a stack. Pages added with a key can be evicted when more
+ * than maximumLivePages() are alive, the least recently shown first, and are
+ * recreated by the page factory when they are shown again.
+ *
+ * The title bar drags the viewport onto another pane of the same tree:
+ * dropped on an edge it moves next to that pane, dropped on the centre the
+ * two panes swap. Either way the widgets are reparented, not recreated.
+ */
 class Viewport : public QWidget
 {
     Q_OBJECT
 public:
+    using PageFactory = std::function<QWidget *(const QString &key, QWidget *parent)>;
+
     explicit Viewport(Splittable *splittable, QWidget *parent = nullptr);
     ~Viewport() override;
 
@@ -25,23 +46,84 @@ public:
     void setLayoutDirection(QBoxLayout::Direction direction) const;
 
     // TODO: create abstract widget interface
-    void addWidget(QWidget *widget);
+    void addWidget(QWidget *widget, const QString &key = QString());
+    int addPage(const QString &key);
     QWidget *widget() const;
 
     void setCurrentWidget(int index);
     void setCurrentWidget(QWidget *widget);
+    int currentIndex() const;
+
+    int pageCount() const;
+    int livePageCount() const;
+    QString pageKey(int index) const;
+    bool isPageLive(int index) const;
+
+    void setPageFactory(const PageFactory &factory);
+    void setMaximumLivePages(int count);
+    int maximumLivePages() const;
+
+    void setContent(const ViewportContent &content);
+    ViewportContent content() const;
 
     Viewport *duplicate();
 
+    bool isSuspended() const;
+
+    static QString paneMimeType();
+
 signals:
+    void contentChanged();
 
 public slots:
 
+protected:
+    bool event(QEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void dragEnterEvent(QDragEnterEvent *event) override;
+    void dragMoveEvent(QDragMoveEvent *event) override;
+    void dragLeaveEvent(QDragLeaveEvent *event) override;
+    void dropEvent(QDropEvent *event) override;
+
 private:
+    struct Page
+    {
+        QString key;
+        QPointer<QWidget> widget;
+        quint64 used = 0;
+    };
+
+    enum DropZone { NoDrop, LeftDrop, TopDrop, RightDrop, BottomDrop, CentreDrop };
+
+    QWidget *ensurePage(int index);
+    void evictPages();
+
+    void startDrag();
+    QPixmap dragPixmap();
+    Splittable *dragSource(const QMimeData *mime) const;
+    DropZone dropZone(const QPoint &pos) const;
+    QRect dropRect(DropZone zone) const;
+    void showDropIndicator(DropZone zone);
+
     Splittable *m_splittable = nullptr;
     TitleBar *m_titleBar = nullptr;
     QStackedWidget *m_container = nullptr;
     QVBoxLayout *m_layout = nullptr;
+
+    ViewportContent m_content;
+    QPointer<QWidget> m_placeholder;
+    QHash<QString, QSharedPointer<ContentProvider>> m_providers;
+
+    QVector<Page> m_pages;
+    PageFactory m_pageFactory;
+    int m_current = -1;
+    int m_maximumLivePages = 0;
+    bool m_suspended = false;
+    quint64 m_clock = 0;
+
+    QPixmap m_dragPixmap;
+    bool m_dragPixmapDirty = true;
+    QPointer<QRubberBand> m_dropIndicator;
 };
 
 #endif // VIEWPORT_H
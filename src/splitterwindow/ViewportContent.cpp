@@ -0,0 +1,82 @@
+#include "ViewportContent.h"
+
+#include <QVariantMap>
+
+ContentProvider::~ContentProvider()
+{
+
+}
+
+class ViewportContentData : public QSharedData
+{
+public:
+    QSharedPointer<ContentProvider> provider;
+    QString title;
+    QVariantMap properties;
+};
+
+ViewportContent::ViewportContent()
+    : d(new ViewportContentData)
+{
+
+}
+
+ViewportContent::ViewportContent(const QSharedPointer<ContentProvider> &provider)
+    : d(new ViewportContentData)
+{
+    d->provider = provider;
+    if(provider)
+        d->title = provider->key();
+}
+
+ViewportContent::ViewportContent(const ViewportContent &other) = default;
+ViewportContent &ViewportContent::operator=(const ViewportContent &other) = default;
+ViewportContent::~ViewportContent() = default;
+
+bool ViewportContent::isNull() const
+{
+    return d->provider.isNull();
+}
+
+QSharedPointer<ContentProvider> ViewportContent::provider() const
+{
+    return d->provider;
+}
+
+QString ViewportContent::key() const
+{
+    return d->provider ? d->provider->key() : QString();
+}
+
+QString ViewportContent::title() const
+{
+    return d->title;
+}
+
+void ViewportContent::setTitle(const QString &title)
+{
+    // compare on the shared data, writing through d detaches
+    if(d.constData()->title == title)
+        return;
+    d->title = title;
+}
+
+QVariant ViewportContent::property(const QString &name) const
+{
+    return d->properties.value(name);
+}
+
+void ViewportContent::setProperty(const QString &name, const QVariant &value)
+{
+    d->properties.insert(name, value);
+}
+
+/**
+ * @brief ViewportContent::isSharedWith
+ * @return true if both show the same provider, whether or not their
+ * per-view state has been detached
+ */
+bool ViewportContent::isSharedWith(const ViewportContent &other) const
+{
+    return d->provider && d->provider == other.d->provider;
+}
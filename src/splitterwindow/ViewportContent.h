@@ -0,0 +1,61 @@
+#ifndef VIEWPORTCONTENT_H
+#define VIEWPORTCONTENT_H
+
+#include <QSharedDataPointer>
+#include <QSharedPointer>
+#include <QString>
+#include <QVariant>
+
+class QWidget;
+
+/**
+ * @brief The ContentProvider class
+ * Owns the model and the cached resources of a content, and creates any
+ * number of views over them. One provider is shared by every pane showing
+ * the same content.
+ */
+class ContentProvider
+{
+public:
+    virtual ~ContentProvider();
+
+    virtual QString key() const = 0;
+    virtual QWidget *createView(QWidget *parent) = 0;
+};
+
+class ViewportContentData;
+
+/**
+ * @brief The ViewportContent class
+ * Implicitly shared description of what a viewport shows: the provider, the
+ * title and per-view properties. Copies share everything, a copy detaches
+ * only when its title or properties are written, the provider itself is
+ * never copied.
+ */
+class ViewportContent
+{
+public:
+    ViewportContent();
+    explicit ViewportContent(const QSharedPointer<ContentProvider> &provider);
+    ViewportContent(const ViewportContent &other);
+    ViewportContent &operator=(const ViewportContent &other);
+    ~ViewportContent();
+
+    bool isNull() const;
+
+    QSharedPointer<ContentProvider> provider() const;
+    QString key() const;
+
+    QString title() const;
+    void setTitle(const QString &title);
+
+    QVariant property(const QString &name) const;
+    void setProperty(const QString &name, const QVariant &value);
+
+    bool isSharedWith(const ViewportContent &other) const;
+
+private:
+    QSharedDataPointer<ViewportContentData> d;
+};
+
+#endif // VIEWPORTCONTENT_H
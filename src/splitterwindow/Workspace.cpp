@@ -0,0 +1,399 @@
+#include "Workspace.h"
+#include "Splittable.h"
+#include "Viewport.h"
+#include "ViewportContent.h"
+
+#include <QDataStream>
+#include <QPointer>
+#include <QSplitter>
+#include <QStackedLayout>
+#include <QVector>
+
+static const quint32 LayoutMagic = 0x53504c54; // "SPLT"
+static const quint32 LayoutVersion = 1;
+
+enum NodeType : quint8 { LeafNode = 0, BranchNode = 1 };
+
+// limits for layouts read back, a damaged stream must not build a huge tree
+static const quint32 MaximumBranchCount = 256;
+static const int MaximumDepth = 64;
+
+static void saveNode(QDataStream &stream, Splittable *pane)
+{
+    QSplitter *splitter = pane->splitter();
+    if(!splitter)
+    {
+        auto viewport = qobject_cast<Viewport *>(pane->widget());
+        const ViewportContent content = viewport ? viewport->content() : ViewportContent();
+        stream << quint8(LeafNode) << content.key() << content.title();
+        return;
+    }
+
+    QVector<Splittable *> children;
+    for(int i = 0; i < splitter->count(); ++i)
+    {
+        if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+            children.append(child);
+    }
+
+    stream << quint8(BranchNode) << qint32(splitter->orientation()) << splitter->sizes()
+           << quint32(children.count());
+    for(Splittable *child : qAsConst(children))
+        saveNode(stream, child);
+}
+
+/*
+ * A branch is rebuilt by splitting the pane once and then splitting the
+ * newest pane along the same orientation, which adds siblings to the same
+ * splitter, before its children are restored. A branch with the orientation
+ * of its parent can not be nested that way and fails the restore.
+ */
+static bool restoreNode(QDataStream &stream, Splittable *pane, const Workspace::ContentResolver &resolver,
+                        int depth = 0)
+{
+    if(depth > MaximumDepth)
+        return false;
+
+    quint8 type = 0;
+    stream >> type;
+    if(stream.status() != QDataStream::Ok)
+        return false;
+
+    if(type == LeafNode)
+    {
+        QString key, title;
+        stream >> key >> title;
+        auto viewport = qobject_cast<Viewport *>(pane->widget());
+        if(viewport)
+        {
+            ViewportContent content = resolver && !key.isEmpty() ? resolver(key) : ViewportContent();
+            if(!title.isEmpty())
+                content.setTitle(title);
+            viewport->setContent(content);
+        }
+        return stream.status() == QDataStream::Ok;
+    }
+
+    qint32 orientation = 0;
+    QList<int> sizes;
+    quint32 count = 0;
+    stream >> orientation >> sizes >> count;
+    if(stream.status() != QDataStream::Ok || count < 2 || count > MaximumBranchCount)
+        return false;
+    if(orientation != Qt::Horizontal && orientation != Qt::Vertical)
+        return false;
+
+    Splittable *last = pane->split(Qt::Orientation(orientation), 1);
+    for(quint32 i = 2; i < count && last; ++i)
+        last = last->split(Qt::Orientation(orientation), 1);
+
+    QSplitter *splitter = pane->splitter();
+    if(!last || !splitter)
+        return false;
+
+    QVector<Splittable *> children;
+    for(int i = 0; i < splitter->count(); ++i)
+    {
+        if(auto child = qobject_cast<Splittable *>(splitter->widget(i)))
+            children.append(child);
+    }
+    for(Splittable *child : qAsConst(children))
+    {
+        if(!restoreNode(stream, child, resolver, depth + 1))
+            return false;
+    }
+    splitter->setSizes(sizes);
+    return true;
+}
+
+class WorkspacePrivate
+{
+public:
+    WorkspacePrivate(Workspace *q) : q_ptr(q) {}
+
+    struct Preset
+    {
+        QString name;
+        QPointer<Splittable> root;
+        QByteArray layout;
+        quint64 used = 0;
+        qint64 cost = -1; // measured once hidden, -1 while unknown
+    };
+
+    int indexOf(const QString &name) const
+    {
+        for(int i = 0; i < presets.count(); ++i)
+        {
+            if(presets[i].name == name)
+                return i;
+        }
+        return -1;
+    }
+
+    qint64 cost(Preset &preset) const
+    {
+        if(preset.cost < 0)
+            preset.cost = costFunction ? costFunction(preset.root) : Workspace::estimatedCost(preset.root);
+        return preset.cost;
+    }
+
+    /*
+     * Serialize and drop the least recently shown hidden presets until the
+     * live ones fit the budget. The current preset always stays.
+     */
+    void enforceBudget()
+    {
+        if(budget <= 0)
+            return;
+
+        // only presets hidden or added since the last call are measured
+        qint64 total = 0;
+        for(Preset &preset : presets)
+        {
+            if(preset.root)
+                total += cost(preset);
+        }
+
+        while(total > budget)
+        {
+            int oldest = -1;
+            for(int i = 0; i < presets.count(); ++i)
+            {
+                if(i == current || !presets[i].root)
+                    continue;
+                if(oldest < 0 || presets[i].used < presets[oldest].used)
+                    oldest = i;
+            }
+            if(oldest < 0)
+                return;
+
+            Preset &preset = presets[oldest];
+            total -= cost(preset);
+            preset.layout = Workspace::saveLayout(preset.root);
+            layout->removeWidget(preset.root);
+            preset.root->deleteLater();
+            preset.root = nullptr;
+            preset.cost = -1;
+        }
+    }
+
+    Workspace *q_ptr;
+    QStackedLayout *layout = nullptr;
+    QVector<Preset> presets;
+    Workspace::CostFunction costFunction;
+    Workspace::ContentResolver resolver;
+    qint64 budget = 0;
+    int current = -1;
+    quint64 clock = 0;
+};
+
+Workspace::Workspace(QWidget *parent)
+    : QWidget(parent)
+    , d(new WorkspacePrivate(this))
+{
+    d->layout = new QStackedLayout(this);
+    d->layout->setContentsMargins(0, 0, 0, 0);
+}
+
+Workspace::~Workspace()
+{
+
+}
+
+/**
+ * @brief Workspace::addPreset
+ * Add \a root, or a new single pane tree, as the preset \a name. An existing
+ * preset of that name is replaced.
+ * @return the root of the preset
+ */
+Splittable *Workspace::addPreset(const QString &name, Splittable *root)
+{
+    removePreset(name);
+
+    WorkspacePrivate::Preset preset;
+    preset.name = name;
+    preset.root = root ? root : new Splittable();
+    d->presets.append(preset);
+    d->layout->addWidget(preset.root);
+
+    if(d->current < 0)
+        setCurrentPreset(name);
+    else
+        d->enforceBudget();
+    return preset.root;
+}
+
+void Workspace::removePreset(const QString &name)
+{
+    const int index = d->indexOf(name);
+    if(index < 0)
+        return;
+
+    WorkspacePrivate::Preset preset = d->presets.takeAt(index);
+    if(preset.root)
+    {
+        d->layout->removeWidget(preset.root);
+        preset.root->deleteLater();
+    }
+
+    if(d->current == index)
+    {
+        d->current = -1;
+        if(!d->presets.isEmpty())
+            setCurrentPreset(d->presets.first().name);
+    }
+    else if(d->current > index)
+    {
+        --d->current;
+    }
+}
+
+QStringList Workspace::presets() const
+{
+    QStringList names;
+    for(const WorkspacePrivate::Preset &preset : qAsConst(d->presets))
+        names.append(preset.name);
+    return names;
+}
+
+/**
+ * @brief Workspace::setCurrentPreset
+ * Show the preset \a name. A live preset is only made the current widget,
+ * a dropped one is restored from its saved layout first.
+ */
+bool Workspace::setCurrentPreset(const QString &name)
+{
+    const int index = d->indexOf(name);
+    if(index < 0)
+        return false;
+
+    WorkspacePrivate::Preset &preset = d->presets[index];
+    if(!preset.root)
+    {
+        preset.root = restoreLayout(preset.layout, d->resolver);
+        if(!preset.root)
+            preset.root = new Splittable();
+        preset.layout.clear();
+        d->layout->addWidget(preset.root);
+    }
+
+    preset.used = ++d->clock;
+    const bool changed = d->current != index;
+    // the preset shown until now may have changed, it is measured again
+    if(changed && d->current >= 0)
+        d->presets[d->current].cost = -1;
+    d->current = index;
+    d->layout->setCurrentWidget(preset.root);
+    d->enforceBudget();
+
+    if(changed)
+        emit currentPresetChanged(name);
+    return true;
+}
+
+QString Workspace::currentPreset() const
+{
+    return d->current >= 0 ? d->presets[d->current].name : QString();
+}
+
+Splittable *Workspace::currentRoot() const
+{
+    return d->current >= 0 ? d->presets[d->current].root.data() : nullptr;
+}
+
+/**
+ * @brief Workspace::preset
+ * @return the root of the preset \a name, nullptr if it is not alive
+ */
+Splittable *Workspace::preset(const QString &name) const
+{
+    const int index = d->indexOf(name);
+    return index >= 0 ? d->presets[index].root.data() : nullptr;
+}
+
+bool Workspace::isPresetAlive(const QString &name) const
+{
+    return preset(name) != nullptr;
+}
+
+/**
+ * @brief Workspace::setMemoryBudget
+ * Keep hidden presets alive while the estimated cost of all live presets
+ * stays within \a bytes, 0 keeps all of them. A preset is measured once
+ * when it is hidden, changes to a hidden preset are only seen after it was
+ * shown again.
+ */
+void Workspace::setMemoryBudget(qint64 bytes)
+{
+    d->budget = qMax<qint64>(0, bytes);
+    d->enforceBudget();
+}
+
+qint64 Workspace::memoryBudget() const
+{
+    return d->budget;
+}
+
+void Workspace::setCostFunction(const CostFunction &cost)
+{
+    d->costFunction = cost;
+    for(WorkspacePrivate::Preset &preset : d->presets)
+        preset.cost = -1;
+    d->enforceBudget();
+}
+
+/**
+ * @brief Workspace::setContentResolver
+ * Turns the content keys of a saved layout back into viewport content when
+ * a dropped preset is restored.
+ */
+void Workspace::setContentResolver(const ContentResolver &resolver)
+{
+    d->resolver = resolver;
+}
+
+/**
+ * @brief Workspace::estimatedCost
+ * A rough default: one kilobyte per QObject of the tree. Content with large
+ * models should install its own cost function.
+ */
+qint64 Workspace::estimatedCost(Splittable *root)
+{
+    return root ? qint64(root->findChildren<QObject *>().count() + 1) * 1024 : 0;
+}
+
+QByteArray Workspace::saveLayout(Splittable *root)
+{
+    QByteArray layout;
+    if(!root)
+        return layout;
+
+    QDataStream stream(&layout, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << LayoutMagic << LayoutVersion;
+    saveNode(stream, root);
+    return layout;
+}
+
+/**
+ * @brief Workspace::restoreLayout
+ * @return a new tree built from \a layout, nullptr if it can not be read
+ */
+Splittable *Workspace::restoreLayout(const QByteArray &layout, const ContentResolver &resolver)
+{
+    QDataStream stream(layout);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if(magic != LayoutMagic || version != LayoutVersion)
+        return nullptr;
+
+    auto root = new Splittable();
+    if(!restoreNode(stream, root, resolver))
+    {
+        delete root;
+        return nullptr;
+    }
+    return root;
+}
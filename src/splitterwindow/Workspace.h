@@ -0,0 +1,60 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <QWidget>
+
+#include <functional>
+
+class Splittable;
+class ViewportContent;
+
+class WorkspacePrivate;
+
+/**
+ * @brief The Workspace class
+ * Named Splittable trees, the presets, in one QStackedLayout. Switching to a
+ * preset that is alive only changes the current widget. Hidden presets stay
+ * alive while their estimated cost fits the memory budget, the least
+ * recently shown ones beyond it are serialized and deleted, and restored
+ * from that layout when they are shown again.
+ */
+class Workspace : public QWidget
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE_D(d, Workspace)
+public:
+    using ContentResolver = std::function<ViewportContent(const QString &key)>;
+    using CostFunction = std::function<qint64(Splittable *root)>;
+
+    explicit Workspace(QWidget *parent = nullptr);
+    ~Workspace() override;
+
+    Splittable *addPreset(const QString &name, Splittable *root = nullptr);
+    void removePreset(const QString &name);
+    QStringList presets() const;
+
+    bool setCurrentPreset(const QString &name);
+    QString currentPreset() const;
+    Splittable *currentRoot() const;
+
+    Splittable *preset(const QString &name) const;
+    bool isPresetAlive(const QString &name) const;
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+
+    void setCostFunction(const CostFunction &cost);
+    void setContentResolver(const ContentResolver &resolver);
+
+    static qint64 estimatedCost(Splittable *root);
+    static QByteArray saveLayout(Splittable *root);
+    static Splittable *restoreLayout(const QByteArray &layout, const ContentResolver &resolver = ContentResolver());
+
+signals:
+    void currentPresetChanged(const QString &name);
+
+private:
+    QScopedPointer<WorkspacePrivate> d;
+};
+
+#endif // WORKSPACE_H
@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -16,19 +16,37 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    PaneIndex.cpp \
+    PaneOverview.cpp \
+    PaneRegistry.cpp \
+    SnapshotCover.cpp \
+    SplitArea.cpp \
+    SplitController.cpp \
+    SplitTransaction.cpp \
     Splittable.cpp \
     Splitter.cpp \
     TitleBar.cpp \
     Viewport.cpp \
+    ViewportContent.cpp \
+    Workspace.cpp \
     main.cpp \
     MainWindow.cpp
 
 HEADERS += \
     MainWindow.h \
+    PaneIndex.h \
+    PaneOverview.h \
+    PaneRegistry.h \
+    SnapshotCover.h \
+    SplitArea.h \
+    SplitController.h \
+    SplitTransaction.h \
     Splittable.h \
     Splitter.h \
     TitleBar.h \
-    Viewport.h
+    Viewport.h \
+    ViewportContent.h \
+    Workspace.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -3,4 +3,5 @@ TEMPLATE = subdirs
 SUBDIRS += \
     splitterwindow \
     windowframe \
-    qtoastwidget
+    qtoastwidget \
+    benchmark
@@ -8,6 +8,7 @@
 #include <QLayout>
 #include <QtEvents>
 #include <QPointer>
+#include <QTimer>
 #include <QDebug>
 
 class WindowFrame : public QObject
@@ -16,31 +17,42 @@ class WindowFrame : public QObject
 public:
     WindowFrame() = delete;
     explicit WindowFrame(QWidget *target);
+    explicit WindowFrame(QWindow *window, const WindowFrameHelper::DragRegion &dragRegion);
     ~WindowFrame();
 
 protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
-    bool event(QEvent *event) override;
 
-    virtual void showEvent(QShowEvent *event);
-    virtual void resizeEvent(QResizeEvent *event);
-    virtual void enterEvent(QEvent *event);
-    virtual void leaveEvent(QEvent *event);
-    virtual void moveEvent(QMoveEvent *event);
     virtual void mouseHoverEvent(QHoverEvent *event);
     virtual void mouseMoveEvent(QMouseEvent *event);
     virtual void mousePressEvent(QMouseEvent *event);
     virtual void mouseReleaseEvent(QMouseEvent *event);
 
 private:
+    QWindow *windowHandle() const;
+    QRect geometry() const;
+    QSize size() const;
+    void setGeometry(const QRect &rect);
+    QRect availableGeometry(bool *horizontal, bool *vertical) const;
+    bool systemFrameAvailable() const;
+
+    void updateHover(const QPoint &pos);
+    bool inBorderBand(const QPoint &pos) const;
     Qt::Edges edgesFromPoint(const QPoint &pos) const;
     void updateCursorShape(Qt::Edges edges);
     bool atBottom() const;
     bool atLeft() const;
     void updateGeometry(const QPoint &pos);
+    void applyPendingGeometry();
+    int frameInterval() const;
 
 private:
+    // frames to wait for the window system to acknowledge a geometry change
+    static const int MaximumConfigureWait = 3;
+
     QPointer<QWidget> m_target;
+    QPointer<QWindow> m_window;
+    WindowFrameHelper::DragRegion m_dragRegion;
     int m_dxMax;
     int m_dyMax;
     int m_border;
@@ -52,6 +64,14 @@ private:
     QPoint m_pressedPos;
     QRect m_rect;
     Qt::Edges m_edges;
+    Qt::Edges m_hoverEdges;
+
+    QTimer m_frameTimer;
+    QPoint m_pendingPos;
+    QRect m_requestedRect;
+    bool m_geometryPending;
+    bool m_configurePending;
+    int m_framesWaited;
 };
 
 void WindowFrameHelper::makeWindowFrameless(QWidget *window)
@@ -62,12 +82,12 @@ void WindowFrameHelper::makeWindowFrameless(QWidget *window)
     (void)new WindowFrame(window);
 }
 
-void WindowFrameHelper::makeWindowFrameless(QWindow *window)
+void WindowFrameHelper::makeWindowFrameless(QWindow *window, const DragRegion &dragRegion)
 {
     if(!window)
         return;
 
-    // TODO: IMPLEMENT ME
+    (void)new WindowFrame(window, dragRegion);
 }
 
 WindowFrame::WindowFrame(QWidget *target)
@@ -79,9 +99,15 @@ WindowFrame::WindowFrame(QWidget *target)
     , m_resizeEnabled(false)
     , m_moveEnabled(false)
     , m_mousePressed(false)
+    , m_geometryPending(false)
+    , m_configurePending(false)
+    , m_framesWaited(0)
 {
     Q_ASSERT(target != nullptr);
 
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, [this]() { applyPendingGeometry(); });
+
     const bool visibled = target->isVisible();
 
     // ensure it is a top level window
@@ -95,6 +121,30 @@ WindowFrame::WindowFrame(QWidget *target)
     target->installEventFilter(this);
 }
 
+WindowFrame::WindowFrame(QWindow *window, const WindowFrameHelper::DragRegion &dragRegion)
+    : QObject(window)
+    , m_window(window)
+    , m_dragRegion(dragRegion)
+    , m_dxMax(0)
+    , m_dyMax(0)
+    , m_border(5)
+    , m_resizeEnabled(false)
+    , m_moveEnabled(false)
+    , m_mousePressed(false)
+    , m_geometryPending(false)
+    , m_configurePending(false)
+    , m_framesWaited(0)
+{
+    Q_ASSERT(window != nullptr);
+
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, [this]() { applyPendingGeometry(); });
+
+    // a QWindow keeps its platform window when the flags change
+    window->setFlags(window->flags() | Qt::FramelessWindowHint);
+    window->installEventFilter(this);
+}
+
 WindowFrame::~WindowFrame()
 {
     qDebug() << Q_FUNC_INFO;
@@ -102,88 +152,68 @@ WindowFrame::~WindowFrame()
 
 bool WindowFrame::eventFilter(QObject *watched, QEvent *event)
 {
+    /* The filter sees every event of the window, so anything but the few
+     * mouse events the frame reacts to goes straight back to normal delivery.
+     * Only a bare window loses the presses the frame takes. */
     switch (event->type())
     {
-    case QEvent::Show:
-        showEvent(static_cast<QShowEvent*>(event));
+    case QEvent::HoverMove:
+    case QEvent::MouseMove:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
         break;
+    case QEvent::Move:
+    case QEvent::Resize:
+        // the window system applied a geometry change
+        m_configurePending = false;
+        return false;
+    default:
+        return false;
+    }
+
+    // the frame is a child of the window or widget it decorates
+    if(watched != parent())
+        return false;
 
+    switch (event->type())
+    {
     case QEvent::HoverMove:
         mouseHoverEvent(static_cast<QHoverEvent*>(event));
         break;
 
     case QEvent::MouseMove:
-        mouseMoveEvent((QMouseEvent*)event);
+        if(m_mousePressed)
+        {
+            mouseMoveEvent(static_cast<QMouseEvent*>(event));
+            return !m_window.isNull();
+        }
+        if(m_window) // windows get no hover events
+            updateHover(static_cast<QMouseEvent*>(event)->pos());
         break;
 
     case QEvent::MouseButtonPress:
-        mousePressEvent((QMouseEvent*)event);
-        break;
+        mousePressEvent(static_cast<QMouseEvent*>(event));
+        // the content of a bare window never sees a press the frame took
+        return m_window && (m_mousePressed || m_resizeEnabled || m_moveEnabled);
 
     case QEvent::MouseButtonRelease:
-        mouseReleaseEvent((QMouseEvent*)event);
-        break;
-
-    case QEvent::Enter:
-        enterEvent(event);
-        break;
-
-    case QEvent::Leave:
-        leaveEvent(event);
-        break;
-
-    case QEvent::Move:
-        moveEvent((QMoveEvent*)event);
-        break;
-
-    case QEvent::Resize:
-        resizeEvent((QResizeEvent*)event);
+        if(m_mousePressed)
+        {
+            mouseReleaseEvent(static_cast<QMouseEvent*>(event));
+            return !m_window.isNull();
+        }
         break;
 
     default:
         break;
     }
 
-    return m_target->eventFilter(watched, event);
-}
-
-bool WindowFrame::event(QEvent *event)
-{
-    return QObject::event(event);
-}
-
-void WindowFrame::showEvent(QShowEvent *event)
-{
-    Q_UNUSED(event);
-}
-
-void WindowFrame::resizeEvent(QResizeEvent *event)
-{
-    Q_UNUSED(event);
-}
-
-void WindowFrame::enterEvent(QEvent *event)
-{
-    Q_UNUSED(event);
-}
-
-void WindowFrame::leaveEvent(QEvent *event)
-{
-    Q_UNUSED(event);
-}
-
-void WindowFrame::moveEvent(QMoveEvent *event)
-{
-    Q_UNUSED(event);
-    // We're inside a resize operation; no update necessary.
-    if(m_mousePressed)
-        return;
+    return false;
 }
 
 void WindowFrame::mouseHoverEvent(QHoverEvent *event)
 {
-    Qt::Edges edges = edgesFromPoint(event->pos());
-    updateCursorShape(edges);
+    updateHover(event->pos());
 }
 
 void WindowFrame::mouseMoveEvent(QMouseEvent *event)
@@ -191,10 +221,18 @@ void WindowFrame::mouseMoveEvent(QMouseEvent *event)
     if (event->buttons() != Qt::LeftButton || m_resizeEnabled || m_moveEnabled)
         return;
 
-    if (!m_mousePressed || m_target->testAttribute(Qt::WA_WState_ConfigPending))
+    if (!m_mousePressed)
         return;
 
-    updateGeometry(event->globalPos());
+    /* Moves are coalesced: only the latest position is applied, at most once
+     * per display frame, so the window manager is not flooded with resizes. */
+    m_pendingPos = event->globalPos();
+    m_geometryPending = true;
+    if (!m_frameTimer.isActive())
+    {
+        applyPendingGeometry();
+        m_frameTimer.start(frameInterval());
+    }
 }
 
 void WindowFrame::mousePressEvent(QMouseEvent *event)
@@ -202,49 +240,44 @@ void WindowFrame::mousePressEvent(QMouseEvent *event)
     if (event->button() != Qt::LeftButton)
         return;
 
+    m_resizeEnabled = false;
+    m_moveEnabled = false;
+
+    /* A bare window gets every press before its content: only the border
+     * and the drag region it opted in to belong to the frame. */
+    const Qt::Edges edges = edgesFromPoint(event->pos());
+    if (m_window && edges == 0 && !(m_dragRegion && m_dragRegion(event->pos())))
+        return;
+
     m_pressedPos = event->globalPos();
     m_mousePressed = true;
-    m_rect = m_target->geometry();
+    m_rect = geometry();
+    m_edges = edges;
 
-    if (m_target->isWindow()
-            && m_target->windowHandle()
-            && !(m_target->windowFlags() & Qt::X11BypassWindowManagerHint)
-            && !m_target->testAttribute(Qt::WA_DontShowOnScreen)
-            && !m_target->hasHeightForWidth())
+    if (systemFrameAvailable())
     {
-        m_edges = edgesFromPoint(m_target->mapFromGlobal(m_pressedPos));
         if(m_edges != 0)
         {
-            m_resizeEnabled = m_target->windowHandle()->startSystemResize(m_edges);
+            m_resizeEnabled = windowHandle()->startSystemResize(m_edges);
         }
         else
         {
-            m_moveEnabled = m_target->windowHandle()->startSystemMove();
+            m_moveEnabled = windowHandle()->startSystemMove();
         }
     }
 
+    // the window system owns the drag now, the release may never arrive
     if(m_resizeEnabled || m_moveEnabled)
+    {
+        m_mousePressed = false;
         return;
+    }
 
     // Find available desktop/workspace geometry.
-    QRect availableGeometry;
     bool hasVerticalSizeConstraint = true;
     bool hasHorizontalSizeConstraint = true;
-    if (m_target->isWindow())
-    {
-        availableGeometry =m_target-> windowHandle()->screen()->availableGeometry();
-    }
-    else
-    {
-        const QWidget *tlwParent = m_target->parentWidget();
-        QAbstractScrollArea *scrollArea = qobject_cast<QAbstractScrollArea *>(tlwParent->parentWidget());
-        if (scrollArea)
-        {
-            hasHorizontalSizeConstraint = scrollArea->horizontalScrollBarPolicy() == Qt::ScrollBarAlwaysOff;
-            hasVerticalSizeConstraint = scrollArea->verticalScrollBarPolicy() == Qt::ScrollBarAlwaysOff;
-        }
-        availableGeometry = tlwParent->contentsRect();
-    }
+    const QRect availableGeometry = this->availableGeometry(&hasHorizontalSizeConstraint,
+                                                            &hasVerticalSizeConstraint);
 
     // TODO: Find frame geometries, title bar height, and decoration sizes
     // ...
@@ -284,21 +317,115 @@ void WindowFrame::mouseReleaseEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton)
     {
+        // the window ends up exactly where the button was released
+        m_frameTimer.stop();
+        if (m_geometryPending)
+        {
+            m_geometryPending = false;
+            updateGeometry(m_pendingPos);
+        }
+
         m_mousePressed = false;
+        m_resizeEnabled = false;
+        m_moveEnabled = false;
         m_pressedPos = QPoint();
     }
 }
 
+QWindow *WindowFrame::windowHandle() const
+{
+    return m_target ? m_target->windowHandle() : m_window.data();
+}
+
+QRect WindowFrame::geometry() const
+{
+    return m_target ? m_target->geometry() : m_window->geometry();
+}
+
+QSize WindowFrame::size() const
+{
+    return m_target ? m_target->size() : m_window->size();
+}
+
+void WindowFrame::setGeometry(const QRect &rect)
+{
+    m_requestedRect = rect;
+    if (rect == geometry())
+        return;
+
+    // cleared by the Move or Resize event, which may be sent right away
+    m_configurePending = true;
+    m_framesWaited = 0;
+    if (m_target)
+        m_target->setGeometry(rect);
+    else
+        m_window->setGeometry(rect);
+}
+
+QRect WindowFrame::availableGeometry(bool *horizontal, bool *vertical) const
+{
+    if (m_target && !m_target->isWindow())
+    {
+        const QWidget *tlwParent = m_target->parentWidget();
+        QAbstractScrollArea *scrollArea = qobject_cast<QAbstractScrollArea *>(tlwParent->parentWidget());
+        if (scrollArea)
+        {
+            *horizontal = scrollArea->horizontalScrollBarPolicy() == Qt::ScrollBarAlwaysOff;
+            *vertical = scrollArea->verticalScrollBarPolicy() == Qt::ScrollBarAlwaysOff;
+        }
+        return tlwParent->contentsRect();
+    }
+
+    QWindow *window = windowHandle();
+    QScreen *screen = window ? window->screen() : QGuiApplication::primaryScreen();
+    return screen ? screen->availableGeometry() : QRect();
+}
+
+bool WindowFrame::systemFrameAvailable() const
+{
+    QWindow *window = windowHandle();
+    if (!window || (window->flags() & Qt::X11BypassWindowManagerHint))
+        return false;
+
+    if (m_target)
+        return m_target->isWindow()
+                && !m_target->testAttribute(Qt::WA_DontShowOnScreen)
+                && !m_target->hasHeightForWidth();
+
+    return true;
+}
+
+void WindowFrame::updateHover(const QPoint &pos)
+{
+    /* The cursor is only touched on transitions: moves over the client area
+     * or along the same edge do not reach the platform at all. */
+    const Qt::Edges edges = inBorderBand(pos) ? edgesFromPoint(pos) : Qt::Edges();
+    if(edges == m_hoverEdges)
+        return;
+
+    m_hoverEdges = edges;
+    updateCursorShape(edges);
+}
+
+bool WindowFrame::inBorderBand(const QPoint &pos) const
+{
+    const QSize size = this->size();
+    return pos.x() < m_border || pos.y() < m_border
+            || pos.x() > size.width() - m_border
+            || pos.y() > size.height() - m_border;
+}
+
 Qt::Edges WindowFrame::edgesFromPoint(const QPoint &pos) const
 {
+    const QSize size = this->size();
     Qt::Edges edges;
     if(pos.x() < m_border)
        edges |= Qt::LeftEdge;
     if(pos.y() < m_border)
        edges |= Qt::TopEdge;
-    if(pos.x() > m_target->width() - m_border)
+    if(pos.x() > size.width() - m_border)
        edges |= Qt::RightEdge;
-    if(pos.y() > m_target-> height() - m_border)
+    if(pos.y() > size.height() - m_border)
         edges |= Qt::BottomEdge;
 
     return edges;
@@ -306,6 +433,15 @@ Qt::Edges WindowFrame::edgesFromPoint(const QPoint &pos) const
 
 void WindowFrame::updateCursorShape(Qt::Edges edges)
 {
+    if (edges == 0)
+    {
+        if (m_target)
+            m_target->unsetCursor();
+        else
+            m_window->unsetCursor();
+        return;
+    }
+
     Qt::CursorShape cursorShape;
     if (edges == Qt::LeftEdge || edges == Qt::RightEdge)
         cursorShape = Qt::SizeHorCursor;
@@ -322,49 +458,80 @@ void WindowFrame::updateCursorShape(Qt::Edges edges)
     else
         cursorShape = Qt::ArrowCursor;
 
-    m_target->setCursor(cursorShape);
+    if (m_target)
+        m_target->setCursor(cursorShape);
+    else
+        m_window->setCursor(cursorShape);
 }
 
 bool WindowFrame::atBottom() const
 {
-    return m_edges == (Qt::BottomEdge | Qt::LeftEdge) || m_edges == (Qt::BottomEdge | Qt::RightEdge);
+    return m_edges.testFlag(Qt::BottomEdge);
 }
 
 bool WindowFrame::atLeft() const
 {
-    return m_edges == (Qt::BottomEdge | Qt::LeftEdge) || m_edges == (Qt::TopEdge | Qt::LeftEdge);
+    return m_edges.testFlag(Qt::LeftEdge);
 }
 
 void WindowFrame::updateGeometry(const QPoint &pos)
 {
-    QSize ns;
-    if(atBottom())
-        ns.rheight() = m_rect.height() + qMin(pos.y() - m_pressedPos.y(), m_dyMax);
-    else
-        ns.rheight() = m_rect.height() - qMax(pos.y() - m_pressedPos.y(), m_dyMax);
+    const QPoint delta = pos - m_pressedPos;
 
-    if (atLeft())
-        ns.rwidth() = m_rect.width() - qMax(pos.x() - m_pressedPos.x(), m_dxMax);
-    else
-        ns.rwidth() = m_rect.width() + qMin(pos.x() - m_pressedPos.x(), m_dxMax);
-
-    ns = QLayout::closestAcceptableSize(m_target, ns);
-    QPoint p;
-    QRect nr(p, ns);
-    if (atBottom())
+    // pressed outside the border: the window is moved, not resized
+    if (m_edges == 0)
     {
-        if (atLeft())
-            nr.moveTopRight(m_rect.topRight());
-        else
-            nr.moveTopLeft(m_rect.topLeft());
+        setGeometry(m_rect.translated(delta));
+        return;
     }
+
+    QSize ns = m_rect.size();
+    if (atBottom())
+        ns.rheight() += qMin(delta.y(), m_dyMax);
+    else if (m_edges.testFlag(Qt::TopEdge))
+        ns.rheight() -= qMax(delta.y(), m_dyMax);
+
+    if (atLeft())
+        ns.rwidth() -= qMax(delta.x(), m_dxMax);
+    else if (m_edges.testFlag(Qt::RightEdge))
+        ns.rwidth() += qMin(delta.x(), m_dxMax);
+
+    if (m_target)
+        ns = QLayout::closestAcceptableSize(m_target, ns);
     else
+        ns = ns.expandedTo(m_window->minimumSize()).boundedTo(m_window->maximumSize());
+
+    // the edges opposite to the dragged ones stay in place
+    QRect nr(m_rect.topLeft(), ns);
+    if (atLeft())
+        nr.moveRight(m_rect.right());
+    if (m_edges.testFlag(Qt::TopEdge))
+        nr.moveBottom(m_rect.bottom());
+
+    setGeometry(nr);
+}
+
+void WindowFrame::applyPendingGeometry()
+{
+    if (!m_geometryPending)
     {
-        if (atLeft())
-            nr.moveBottomRight(m_rect.bottomRight());
-        else
-            nr.moveBottomLeft(m_rect.bottomLeft());
+        m_frameTimer.stop();
+        return;
     }
 
-    m_target->setGeometry(nr);
+    // give the window system a few frames to acknowledge the last change
+    if (m_configurePending && geometry() != m_requestedRect
+            && ++m_framesWaited < MaximumConfigureWait)
+        return;
+
+    m_geometryPending = false;
+    updateGeometry(m_pendingPos);
+}
+
+int WindowFrame::frameInterval() const
+{
+    QWindow *window = windowHandle();
+    QScreen *screen = window ? window->screen() : QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60;
+    return qMax(1, qRound(1000 / refreshRate));
 }
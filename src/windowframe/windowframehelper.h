@@ -1,13 +1,19 @@
 #ifndef WINDOWFRAMEHELPER_H
 #define WINDOWFRAMEHELPER_H
 
+#include <functional>
+
+class QPoint;
 class QWidget;
 class QWindow;
 
 namespace WindowFrameHelper
 {
+    // true if a press at the position, in window coordinates, moves the window
+    using DragRegion = std::function<bool(const QPoint &pos)>;
+
     void makeWindowFrameless(QWidget *window);
-    void makeWindowFrameless(QWindow *window);
+    void makeWindowFrameless(QWindow *window, const DragRegion &dragRegion = DragRegion());
 }
 
 #endif // WINDOWFRAMEHELPER_H